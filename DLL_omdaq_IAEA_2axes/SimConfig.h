@@ -0,0 +1,20 @@
+///--------------------------------------------------------------------------
+// SIMCONFIG.H
+// Stage simulated by this DLL: the two-axis (XY) IAEA stage.  The simulator
+// itself is ../DLL_omdaq_common/OmXyzSimulator.cpp, compiled with this
+// folder in the include path.
+// ---------------------------------------------------------------------------
+
+#ifndef SimConfigH
+#define SimConfigH
+
+// The simulated stage has two axes, X and Y, with power switching and
+// temperature sensors (see XyzStageConfig.h).  OMDAQ-3 only knows stages with
+// three linear axes, so Z is reported too, always in position and powered,
+// but it isn't simulated.  There are no rotation axes.
+typedef XyzStageConfig<3, 0, XYZCAP_POWER_ONOFF | XYZCAP_TEMPSENSOR,
+	XyzAxisBits(2, 0)> SimConfig;
+
+#define SimDescription "XY stage controlled by user-supplied DLL"
+
+#endif
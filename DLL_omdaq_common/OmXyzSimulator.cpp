@@ -0,0 +1,1303 @@
+// ---------------------------------------------------------------------------
+//
+// This file contains dummy procedure bodies as examples and for testing.
+//
+// The code in these procedures simulates the stage described by the
+// SimConfig.h of the DLL being built, e.g. the XYZ-3R stage of
+// DLL_omdaq_universal or the XY stage of DLL_omdaq_IAEA_2axes.  The project
+// of each simulator DLL compiles this file with the folder of the DLL (its
+// SimConfig.h and OmXyzDll headers) in the include path.
+//
+// ---------------------------------------------------------------------------
+#pragma hdrstop
+#include <math.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+
+#define XYZDLL_EXPORTS 1
+#include "OmXyzDll.h"
+#include "OmXyzDllExt.h"
+#include "SeqLock.h"
+#include "XyzStageConfig.h"
+#include "SimConfig.h"
+// ---------------------------------------------------------------------------
+#pragma package(smart_init)
+
+// ______Local variables for testing____________________________
+//
+// SimConfig (see SimConfig.h) gives the simulated axes and SimDescription
+// the text of XyzDescription.
+
+// Each simulated move is stored as its start time, start and end points and
+// velocity profile, so that the position at any time is calculated directly
+// from the move (see SimPosition) and reading the position doesn't change
+// anything.  A stage at rest is a move with Start == End.
+// The profile is a jerk-limited S-curve of SimSegments segments:
+//   0 jerk up, 1 constant accel, 2 jerk down, 3 cruise,
+//   4 jerk down, 5 constant decel, 6 jerk up.
+// tSeg[k] is the start time of segment k (from tStart) and Travel, Vel, Acc
+// and Jerk the distance, speed, acceleration and jerk at that time, so the
+// position anywhere in the segment is a cubic in the time.  Segments that
+// aren't needed have zero length: without a jerk limit the profile is
+// trapezoidal, and short moves have no cruise or no constant accel.
+// Speed, Accel and Jerk <= 0 mean no limit (Speed <= 0 never gets there).
+// Times are in seconds, read from the clock of the stage (see SimNow).
+#define SimSegments 7
+struct SimMove {
+  double tStart;
+  double Start;
+  double End;
+  double Duration;
+  double tSeg[SimSegments + 1];
+  double Travel[SimSegments];
+  double Vel[SimSegments];
+  double Acc[SimSegments];
+  double Jerk[SimSegments];
+};
+#define nOptions 2
+
+// The state the status calls need: the moves of the axes, the power and the
+// clock.  Only the driven axes of SimConfig have a move (see SimAxisMove),
+// so the state copied by every status call is no bigger than the stage
+// needs.  The clock is per stage: Source, if not NULL, replaces it, otherwise
+// it is the monotonic clock, virtual or scaled according to ClockMode (see
+// SimNow and XyzSimSetClockMode).
+struct SimState {
+  SimMove Move[SimConfig::nDriven];
+  bool DllPowerOn;
+  XyzTimeSource Source;
+  int ClockMode;
+  double VirtualNow;
+  double ClockOrigin;
+  double ClockRealOrigin;
+  double ClockScale;
+};
+
+// All the state of one simulated stage, so that a process can simulate as
+// many stages as it likes (see XyzCreateStage).  The OMDAQ-3 calls work on
+// DefaultStage.
+// Lock serialises the calls that change the stage.  They change State and
+// then copy it to Published (see SimPublish).  The status calls, which OMDAQ
+// makes from its own thread, only read Published, so they never wait for the
+// lock and never see a half-changed state.  XyzWaitStatusChange waits on
+// StatusChanged, which SimPublish signals.
+// Callback is called by CallbackThread (see SimCallbackWorker), which only
+// runs while a callback is set.  CallbackCaller is the thread in the
+// callback, if any.  CallbackThreads counts the callback threads that have
+// not ended, detached ones included, and CallbackEnded is signalled when one
+// ends (see XyzDestroyStage).
+struct XyzStage {
+  std::mutex Lock;
+  std::condition_variable StatusChanged;
+  XyzMotionCallback Callback = NULL;
+  void *CallbackUser = NULL;
+  std::thread CallbackThread;
+  std::thread::id CallbackCaller;
+  int CallbackThreads = 0;
+  std::condition_variable CallbackEnded;
+  SimState State = {};
+  SeqLock<SimState> Published;
+  double LinSpeed[3] = {};
+  double RotSpeed[3] = {};
+  double LinAccel[3] = {};
+  double RotAccel[3] = {};
+  double LinJerk[3] = {};
+  double RotJerk[3] = {};
+  char OptionText[nOptions][32] = {};
+  bool optionsCopied = false;
+
+  XyzStage() {
+	State.ClockMode = XyzClockReal;
+	State.ClockScale = 1;
+	Published.Write(State);
+  }
+};
+
+XyzStage DefaultStage;
+//
+// _____________________________________________________________
+
+// Default time source: the monotonic (steady) clock, in seconds with
+// nanosecond resolution.  Unlike clock() this is wall time, so simulated
+// moves keep going while OMDAQ is sleeping.
+double _CALLSTYLE_ MonotonicTime() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>
+	  (std::chrono::steady_clock::now().time_since_epoch()).count() * 1e-9;
+}
+
+// Simulation time of a stage.
+// In virtual mode the time only changes when XyzSimAdvanceClock is called.
+// Otherwise it runs at ClockScale times the monotonic clock from ClockOrigin,
+// the simulation time when the mode was last changed, so the simulated time
+// never jumps.  By default (origins 0, scale 1) it is the monotonic clock.
+double SimNow(const SimState &Stage) {
+  if (Stage.Source != NULL) {
+	return Stage.Source();
+  }
+  if (Stage.ClockMode == XyzClockVirtual) {
+	return Stage.VirtualNow;
+  }
+  return Stage.ClockOrigin + (MonotonicTime() - Stage.ClockRealOrigin) *
+	  Stage.ClockScale;
+}
+
+// Time at which a simulated move reaches its end point.
+double SimEndTime(const SimMove &Move) {
+  return Move.tStart + Move.Duration;
+}
+
+// Position of a simulated move at time t.  If Segment is not NULL it gets
+// the segment of the profile the move is in at time t (0 to 2 accelerating,
+// 3 at constant speed, 4 to 6 decelerating), or -1 if the move is over.
+double SimPosition(const SimMove &Move, double t, int *Segment = NULL) {
+  if (t >= SimEndTime(Move)) {
+	if (Segment != NULL) {
+	  *Segment = -1;
+	}
+	return Move.End;
+  }
+  double dt = t - Move.tStart;
+  int k = 0;
+  while (k < SimSegments - 1 && dt >= Move.tSeg[k + 1]) {
+	++k;
+  }
+  if (Segment != NULL) {
+	*Segment = k;
+  }
+  dt -= Move.tSeg[k];
+  double travel = Move.Travel[k] + dt * (Move.Vel[k] + dt * (Move.Acc[k] / 2 +
+	  dt * Move.Jerk[k] / 6));
+  return (Move.End > Move.Start) ? Move.Start + travel : Move.Start - travel;
+}
+
+// Simulated motor temperature at time t.  The motor warms up towards
+// MotorTempAmbient + MotorTempRise while it moves and cools down afterwards,
+// with time constant MotorTempTau (seconds).  It is calculated from the last
+// move only, so it follows the simulation clock like the position does.
+#define MotorTempAmbient 25.0
+#define MotorTempRise 5.0
+#define MotorTempTau 60.0
+
+double SimMotorTemp(const SimMove &Move, double t) {
+  double tEnd = SimEndTime(Move);
+  if (t < tEnd) {
+	return MotorTempAmbient + MotorTempRise *
+		(1 - exp(-(t - Move.tStart) / MotorTempTau));
+  }
+  return MotorTempAmbient + MotorTempRise *
+	  (1 - exp(-(tEnd - Move.tStart) / MotorTempTau)) *
+	  exp(-(t - tEnd) / MotorTempTau);
+}
+
+// Move of axis i (0 to 5, linear axes first), NULL if the axis isn't
+// driven (see SimConfig).
+SimMove *SimAxisMove(SimState &State, int i) {
+  return SimConfig::IsDriven(i) ? &State.Move[SimConfig::Slot(i)] : NULL;
+}
+
+const SimMove *SimAxisMove(const SimState &State, int i) {
+  return SimConfig::IsDriven(i) ? &State.Move[SimConfig::Slot(i)] : NULL;
+}
+
+// Position and motor temperature of axis i at time t.  Axes that aren't
+// driven stay at 0 and at ambient temperature.
+double SimAxisPosition(const SimState &State, int i, double t) {
+  const SimMove *Move = SimAxisMove(State, i);
+  return (Move != NULL) ? SimPosition(*Move, t) : 0;
+}
+
+double SimAxisTemp(const SimState &State, int i, double t) {
+  const SimMove *Move = SimAxisMove(State, i);
+  return (Move != NULL) ? SimMotorTemp(*Move, t) : MotorTempAmbient;
+}
+
+// Sets the stage at rest at Position from time t.
+void SimSetPosition(SimMove &Move, double Position, double t) {
+  Move.tStart = t;
+  Move.Start = Position;
+  Move.End = Position;
+  Move.Duration = 0;
+  for (int k = 0; k < SimSegments; ++k) {
+	Move.tSeg[k] = 0;
+	Move.Travel[k] = 0;
+	Move.Vel[k] = 0;
+	Move.Acc[k] = 0;
+	Move.Jerk[k] = 0;
+  }
+  Move.tSeg[SimSegments] = 0;
+}
+
+// Acceleration phase from rest to Speed: total time Ta, of which Tj at each
+// end is spent ramping the acceleration (jerk phases) up to Peak.
+// The distance covered is Speed * Ta / 2.
+void SimAccelPhase(double Speed, double Accel, double Jerk, double &Ta,
+	double &Tj, double &Peak) {
+  if (Jerk <= 0) {
+	Tj = 0;
+	Ta = (Accel > 0) ? Speed / Accel : 0;
+	Peak = Accel;
+  }
+  else if (Accel <= 0 || Speed * Jerk < Accel * Accel) {
+	// Doesn't reach Accel
+	Tj = sqrt(Speed / Jerk);
+	Ta = 2 * Tj;
+	Peak = Jerk * Tj;
+  }
+  else {
+	Tj = Accel / Jerk;
+	Ta = Tj + Speed / Accel;
+	Peak = Accel;
+  }
+}
+
+// Starts a move at time tNow from the position at that time to End, with the
+// profile given by Speed, Accel and Jerk.  The segment table is worked out
+// here once, so SimPosition only has to evaluate one cubic.  A move that
+// replaces one in progress starts from rest at the current position.
+void SimStartMove(SimMove &Move, double End, double Speed, double Accel,
+	double Jerk, double tNow) {
+  SimSetPosition(Move, SimPosition(Move, tNow), tNow);
+  Move.End = End;
+  double distance = fabs(End - Move.Start);
+  if (distance == 0) {
+	return;
+  }
+  if (Speed <= 0) {
+	// Never gets there
+	for (int k = 4; k <= SimSegments; ++k) {
+	  Move.tSeg[k] = HUGE_VAL;
+	}
+	Move.Duration = HUGE_VAL;
+	return;
+  }
+  double Ta, Tj, Peak;
+  SimAccelPhase(Speed, Accel, Jerk, Ta, Tj, Peak);
+  if (Speed * Ta > distance) {
+	// Too short to reach Speed: find the top speed that just covers distance.
+	if (Jerk <= 0) {
+	  Speed = sqrt(distance * Accel);
+	}
+	else {
+	  Speed = pow(distance * sqrt(Jerk) / 2, 2.0 / 3.0);
+	  if (Accel > 0 && Speed * Jerk >= Accel * Accel) {
+		double ta = Accel / Jerk;
+		Speed = Accel / 2 * (sqrt(ta * ta + 4 * distance / Accel) - ta);
+	  }
+	}
+	SimAccelPhase(Speed, Accel, Jerk, Ta, Tj, Peak);
+  }
+  double Tv = fmax((distance - Speed * Ta) / Speed, 0.0);
+  double Length[SimSegments] = {Tj, Ta - 2 * Tj, Tj, Tv, Tj, Ta - 2 * Tj, Tj};
+  double Acc[SimSegments] = {0, Peak, Peak, 0, 0, -Peak, -Peak};
+  double Jrk = (Jerk > 0) ? Jerk : 0;
+  double JerkSeg[SimSegments] = {Jrk, 0, -Jrk, 0, -Jrk, 0, Jrk};
+  double t = 0, s = 0, v = 0;
+  for (int k = 0; k < SimSegments; ++k) {
+	double T = Length[k];
+	if (k == 3) {
+	  // Cruise at Speed, also when there is no acceleration phase (no limit)
+	  v = Speed;
+	}
+	Move.tSeg[k] = t;
+	Move.Travel[k] = s;
+	Move.Vel[k] = v;
+	Move.Acc[k] = Acc[k];
+	Move.Jerk[k] = JerkSeg[k];
+	s += T * (v + T * (Acc[k] / 2 + T * JerkSeg[k] / 6));
+	v += T * (Acc[k] + T * JerkSeg[k] / 2);
+	t += T;
+  }
+  Move.tSeg[SimSegments] = t;
+  Move.Duration = t;
+}
+
+// Simulated limits (mm and deg) of the axes, linear axes first.  An axis
+// beyond -SimLimit or +SimLimit reports the negative or positive limit.
+const double SimLimit[6] = {20.0, 20.0, 20.0, 90.0, 90.0, 90.0};
+
+// Limit flags of axis i at Position: 1 at the negative limit, 2 at the
+// positive one.
+int SimLimitState(int i, double Position) {
+  return (Position < -SimLimit[i]) + 2 * (Position > SimLimit[i]);
+}
+
+// Status of axis iAxis (all axes if iAxis = -1) at time tNow, and its detail
+// words if AxisStatus is not NULL (see XyzAxisStatus).
+DRVSTAT SimStatus(const SimState &State, double tNow, int iAxis,
+	DWORD *AxisStatus) {
+  DRVSTAT status = 0;
+
+  // Only the axes asked for are evaluated.  The loop is unrolled over the
+  // axes of SimConfig: axes that aren't simulated are in position and
+  // missing in the detail words, axes that aren't reported give nothing.
+  // The flags of an axis are the results of the tests (0 or 1) times the
+  // flag bits, shifted into the byte of the axis (see XyzStatusShift).
+  DRVSTAT PowerOn = State.DllPowerOn;
+  SimConfig::ForEachAxis([&](auto Axis) {
+	constexpr int i = decltype(Axis)::value;
+	if (iAxis >= 0 && iAxis != i) {
+	  return;
+	}
+	DWORD *Detail = (AxisStatus == NULL) ? NULL :
+		AxisStatus + ((iAxis >= 0) ? 0 : i);
+	if (!SimConfig::IsDriven(i)) {
+	  status |= SimConfig::Reported(i) * XyzAxisFlags(i,
+		  XyzStInPosition | PowerOn * XyzStMotorOn);
+	  if (Detail != NULL) {
+		*Detail = AX_MISSING;
+	  }
+	  return;
+	}
+	const SimMove &Move = State.Move[SimConfig::Slot(i)];
+	int Segment;
+	double Position = SimPosition(Move, tNow, &Segment);
+	DRVSTAT Moving = Segment >= 0;
+	DRVSTAT NegLim = Position < -SimLimit[i];
+	DRVSTAT PosLim = Position > SimLimit[i];
+	DRVSTAT Flags = Moving * XyzStMoving | (1 - Moving) * XyzStInPosition |
+		NegLim * XyzStNegLim | PosLim * XyzStPosLim | PowerOn * XyzStMotorOn;
+	status |= XyzAxisFlags(i, Flags);
+	// The detail word comes from the same tests, plus the phase of the
+	// profile given by the segment.
+	if (Detail != NULL) {
+	  DRVSTAT Accel = Moving * (Segment < 3);
+	  DRVSTAT Cruise = Segment == 3;
+	  DRVSTAT Decel = Segment > 3;
+	  *Detail = (DWORD)(AX_ACTIVE | PowerOn * AX_MOTOR_ON |
+		  Moving * AX_MOVING | NegLim * AX_NEG_LIMIT | PosLim * AX_POS_LIMIT |
+		  Accel * AX_ACCEL | Cruise * AX_CONST_SPEED | Decel * AX_DECEL);
+	}
+  });
+  return status;
+}
+
+// Simulation time after tNow at which the status can next change without a
+// new state being published: the end of a move or an axis passing one of
+// its limits.  HUGE_VAL if no axis is moving.
+double SimNextChange(const SimState &State, double tNow) {
+  double tNext = HUGE_VAL;
+  for (int i = 0; i < 6; ++i) {
+	const SimMove *Move = SimAxisMove(State, i);
+	if (Move == NULL || tNow >= SimEndTime(*Move)) {
+	  continue;
+	}
+	double tEnd = SimEndTime(*Move);
+	tNext = fmin(tNext, tEnd);
+	// A move never turns back, so the limit state changes at most twice.
+	// Find the first change by bisection.
+	int Before = SimLimitState(i, SimPosition(*Move, tNow));
+	if (tEnd < HUGE_VAL && Before != SimLimitState(i, Move->End)) {
+	  double tLow = tNow;
+	  double tHigh = tEnd;
+	  for (int k = 0; k < 50; ++k) {
+		double tMid = (tLow + tHigh) / 2;
+		if (SimLimitState(i, SimPosition(*Move, tMid)) == Before) {
+		  tLow = tMid;
+		}
+		else {
+		  tHigh = tMid;
+		}
+	  }
+	  tNext = fmin(tNext, tHigh);
+	}
+  }
+  return tNext;
+}
+
+// Real time (s) until the simulation time gets from tNow to tSim.  HUGE_VAL
+// if the clock doesn't get there by itself (virtual clock).  The rate of a
+// time source set with XyzSimSetTimeSource is unknown, so it is checked
+// every millisecond.
+double SimRealDelay(const SimState &State, double tNow, double tSim) {
+  if (tSim == HUGE_VAL || State.ClockMode == XyzClockVirtual) {
+	return HUGE_VAL;
+  }
+  if (State.Source != NULL) {
+	return fmin(tSim - tNow, 0.001);
+  }
+  if (State.ClockMode == XyzClockScaled) {
+	return (State.ClockScale > 0) ? (tSim - tNow) / State.ClockScale : HUGE_VAL;
+  }
+  return tSim - tNow;
+}
+
+// Fills Snapshot with State at the simulation time tNow.
+void SimSnapshot(const SimState &State, double tNow,
+	struct XyzSnapshot *Snapshot) {
+  Snapshot->Time = tNow;
+  for (int i = 0; i < 3; ++i) {
+	Snapshot->Position[i] = SimAxisPosition(State, i, tNow);
+	Snapshot->Angle[i] = SimAxisPosition(State, i + 3, tNow);
+  }
+  for (int i = 0; i < 6; ++i) {
+	Snapshot->MotorTemp[i] = SimAxisTemp(State, i, tNow);
+  }
+  Snapshot->Status = SimStatus(State, tNow, -1, Snapshot->AxisStatus);
+}
+
+// Publishes the state of Stage to the status calls and wakes up the
+// XyzWaitStatusChange calls.  Called with the lock held by every call that
+// changes the state.
+void SimPublish(XyzStage *Stage) {
+  Stage->Published.Write(Stage->State);
+  Stage->StatusChanged.notify_all();
+}
+
+// Body of the callback thread of a stage.  The simulator has no motion
+// thread, so this thread sleeps like XyzWaitStatusChange until a new state
+// is published or the next time the status can change by itself, and calls
+// the callback with the XyzMotionEvents bits that were set since it last
+// looked.  The lock is released during the call.  The thread ends when it
+// is no longer the stage's CallbackThread (see SimStopCallback).
+void SimCallbackWorker(XyzStage *Stage) {
+  std::unique_lock<std::mutex> lock(Stage->Lock);
+  DRVSTAT Last = SimStatus(Stage->State, SimNow(Stage->State), -1, NULL);
+  while (Stage->CallbackThread.get_id() == std::this_thread::get_id()) {
+	double tNow = SimNow(Stage->State);
+	DRVSTAT NewStatus = SimStatus(Stage->State, tNow, -1, NULL);
+	DRVSTAT Events = NewStatus & ~Last & XyzMotionEvents;
+	Last = NewStatus;
+	if (Events != 0) {
+	  XyzSnapshot Snapshot;
+	  SimSnapshot(Stage->State, tNow, &Snapshot);
+	  XyzMotionCallback Callback = Stage->Callback;
+	  void *User = Stage->CallbackUser;
+	  Stage->CallbackCaller = std::this_thread::get_id();
+	  lock.unlock();
+	  Callback(User, Events, &Snapshot);
+	  lock.lock();
+	  Stage->CallbackCaller = std::thread::id();
+	  continue;
+	}
+	double Delay = SimRealDelay(Stage->State, tNow,
+		SimNextChange(Stage->State, tNow));
+	if (Delay == HUGE_VAL) {
+	  Stage->StatusChanged.wait(lock);
+	}
+	else {
+	  Stage->StatusChanged.wait_for(lock,
+		  std::chrono::duration<double>(Delay));
+	}
+  }
+  // Signalled with the lock held: the stage may be freed once it's released.
+  --Stage->CallbackThreads;
+  Stage->CallbackEnded.notify_all();
+}
+
+// True if the call comes from the callback of Stage.
+bool SimInCallback(XyzStage *Stage) {
+  std::lock_guard<std::mutex> lock(Stage->Lock);
+  return Stage->CallbackCaller == std::this_thread::get_id();
+}
+
+// Removes the callback of Stage and waits until its thread has finished, so
+// the callback is not called any more.  Called from the callback the thread
+// can't wait for itself, so it is detached instead: it ends as soon as the
+// callback returns, without calling it again.  XyzDestroyStage waits for it.
+void SimStopCallback(XyzStage *Stage) {
+  std::unique_lock<std::mutex> lock(Stage->Lock);
+  std::thread Thread = std::move(Stage->CallbackThread);
+  Stage->Callback = NULL;
+  Stage->StatusChanged.notify_all();
+  lock.unlock();
+  if (Thread.get_id() == std::this_thread::get_id()) {
+	Thread.detach();
+  }
+  else if (Thread.joinable()) {
+	Thread.join();
+  }
+}
+
+// Adminstration routines ++++++++++++++++++++++++++++++++++++++++++++++++++++
+//
+// XyzCapabilityMask returns a DWORD mask that describes the basic functionality
+// of the hardware and allows OMDAQ to make the user interface.
+// The return value is assembled from the capability constants
+// defined in OmXyzDll_StatusBits.h
+// >>>>>> THIS MUST BE DEFINED <<<<<<<
+XYZ_DLL DWORD _CALLSTYLE_ XyzCapabilityMask() {
+  return SimConfig::CapabilityMask;
+  // This is the stage of SimConfig, e.g. an XYZ + 3R stage with Power Off
+  // capability, temperature sensors and no home switch
+}
+
+//
+// XyzDllVersion returns the version numbers of the DLL file.
+XYZ_DLL bool _CALLSTYLE_ XyzDllVersion(int * majorVersion, int * minorVersion,
+	int * buildNumber) {
+  *majorVersion = 1;
+  *minorVersion = 0;
+  *buildNumber = 12;
+  return true;
+}
+
+//
+// XyzDescription fills a char string that describes the XYZ stage
+// nChar is the length of the supplied buffer (typically 80 characters)
+//
+XYZ_DLL bool _CALLSTYLE_ XyzDescription(char *statusText, int nChar) {
+  strncpy(statusText, SimDescription, nChar);
+  return true;
+}
+
+// XyzHwDescription fills a char string that decsribes the current setup
+// (COM ports, card slot numbers etc.)
+// nChar is the length of the supplied buffer. (typically 80 characters)
+//
+XYZ_DLL bool _CALLSTYLE_ XyzHwDescription(char *statusText, int nChar) {
+  strncpy(statusText, "COM45 9600baud", nChar);
+  return true;
+}
+
+//
+// XyzAuthor returns the author credits and copyrights etc.
+// nChar is the length of the supplied buffer.  (typically 80 characters)
+XYZ_DLL bool _CALLSTYLE_ XyzAuthor(char *statusText, int nChar) {
+  strncpy(statusText,
+	  "DLL written by A. Coder (c), ACME Software Inc., 2020", nChar);
+  return true;
+}
+
+//
+// XyzDisplayDecimals returns the number of decimal places to disply inthe readouts
+// of position in millimetres and angle in degreees (the same value is used for both
+// displays.
+// >>>>>>>>>>>>>  NOTE:  This is no longer used.  OMDAQ sets the display resolution
+// XYZ_DLL int _CALLSTYLE_ XyzDisplayDecimals() {
+// return 3;
+// }
+// -----------------------------------------------------
+
+// ---------Procedures for optional parameters -----------------------------------
+// Any DLL parameters that neeed to be specified at runtime can be passed as
+// strings to the XyzInitialise(...) procedure through the options argument.
+// In order to manage the user interface OMDAQ needs to know the number of
+// and a description of each one.  These are obtained using the XyzOptionCount
+// and XyzOptionHeader procedures. XyzOptionValue returns the current value
+// of an option. This is used primarily BEFORE XyzInitialise() is called to
+// provide sensible starting values for the parameters to assist the user in
+// setting up a new stage.
+//
+XYZ_DLL int _CALLSTYLE_ XyzOptionCount() {
+  return nOptions;
+}
+
+// These allow the DLL to get the parameter filename and the DDL folder from OMDAQ
+XYZ_DLL bool _CALLSTYLE_ XyzSetParameterFileName(wchar_t *cText, int nChar) {
+  // IniFile = UnicodeString(&cText[0]);
+  return true;
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzSetDLLfolder(wchar_t *statusText, int nChar) {
+  return true;
+}
+
+//
+// XyzOptionHeader returns a SHORT description of the optional parameter nHdr.  This is used in the
+// user interface for setting up the stage BEFORE the initialisation routine is called.
+// Should return false if nHdr is out of range.
+XYZ_DLL bool _CALLSTYLE_ XyzOptionHeader(int nHdr, char * optionsHdr,
+	int szOptionsHdr) {
+  bool ok = false;
+  char * initHdrs[nOptions] = {"COM", "Baud"}; // For example...
+  if ((nHdr >= 0) && (nHdr < nOptions)) {
+	strncpy(optionsHdr, initHdrs[nHdr], szOptionsHdr);
+	ok = true;
+  }
+  return ok;
+}
+
+//
+// XyzOptionValue returns the current value of an option.  This is used primarily BEFORE
+// XyzInitialise() is called to provide sensible starting values for the parameters
+// to assist the user in setting up a new stage.
+// Should return false if nHdr is out of range.
+XYZ_DLL bool _CALLSTYLE_ XyzCtxOptionValue(XYZSTAGE Stage, int nHdr,
+	char * optionVal, int szOptionVal) {
+  std::lock_guard<std::mutex> lock(Stage->Lock);
+  bool ok = false;
+  char * initVals[nOptions] = {"COM4", "9600"}; // For example...
+  if ((nHdr >= 0) && (nHdr < nOptions)) {
+	if (!Stage->optionsCopied) {
+	  strncpy(Stage->OptionText[nHdr], initVals[nHdr], 32*sizeof(char));
+	}
+	strncpy(optionVal, Stage->OptionText[nHdr], szOptionVal);
+	ok = true;
+  }
+  return ok;
+}
+//
+// End of administration routines ++++++++++++++++++++++++++++++++++++++++++++
+
+// Initialisation routines +++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// ---------------------------------------------------------------------------
+XYZ_DLL bool _CALLSTYLE_ XyzCtxInitialise(XYZSTAGE Stage, char **options,
+	int szOptions) {
+  // Initialisation code here
+  // This should include e.g.:  allocation of resources, setting up comms link,
+  // starting the controller, finding the home marker, setting up any hardware parameters
+  // such as motor current, motor steps and scaling, encoder steps and scaling, etc.
+  // Speed and Acceleration are set by OMDAQ.
+  //
+  // If the stages have home markers, OMDAQ will move the stage to the position at last shutdown,
+  // othewise, OMDAQ defines the stage position after initialisation to be the position at last shutdown.
+  // Return false if it fails (IMPORTANT!!)
+  //
+  // If the stage needs optional parameters which can be set up at runtime (e.g. COM port
+  // number, bauds, etc.) then these can be passed in as character strings in the options arguments.
+  // These are set by the user in the "Miscellaneous" tab of the XYZ setup dialog
+
+  std::lock_guard<std::mutex> lock(Stage->Lock);
+  if (szOptions != nOptions) {
+	return false;
+  }
+
+  for (int i = 0; i < szOptions; ++i) {
+	ZeroMemory(Stage->OptionText[i], 32*sizeof(char));
+	strncpy(Stage->OptionText[i], options[i], 31);
+  }
+  Stage->optionsCopied = true;
+
+  double tNow = SimNow(Stage->State);
+  for (int i = 0; i < SimConfig::nDriven; ++i) {
+	SimSetPosition(Stage->State.Move[i], 0, tNow);
+  }
+  Stage->State.DllPowerOn = true;
+  SimPublish(Stage);
+  return true;
+}
+
+// ---------------------------------------------------------------------------
+XYZ_DLL bool _CALLSTYLE_ XyzCtxShutDown(XYZSTAGE Stage) {
+  // Full shutdown code here  - stop stage if it's moving,
+  // power down, free comms links and free resources.
+  //
+  // OMDAQ saves the position at shutdown ready for the next startup.
+  // return false if it fails.
+  SimStopCallback(Stage);
+  return true;
+}
+
+// --------------------------------------------------------------------------
+// These procedures initialise the values of the position or angle readouts to the supplied values.
+// NewPosition and NewAngle are pointers to double[3] arrays which contain on entry the
+// new values of the absolute postions (mm) or angles (deg) for axes 0..2
+// Is not required for stages with hardware zero markers, in which case just return true.
+XYZ_DLL bool _CALLSTYLE_ XyzCtxSetCurrentPosition(XYZSTAGE Stage,
+	double * NewPosition) {
+  std::lock_guard<std::mutex> lock(Stage->Lock);
+  double tNow = SimNow(Stage->State);
+  for (int i = 0; i < 3; ++i) {
+	SimMove *Move = SimAxisMove(Stage->State, i);
+	if (Move != NULL) {
+	  SimSetPosition(*Move, NewPosition[i], tNow);
+	}
+  }
+  SimPublish(Stage);
+  return true;
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzCtxSetCurrentAngle(XYZSTAGE Stage, double * NewAngle) {
+  std::lock_guard<std::mutex> lock(Stage->Lock);
+  double tNow = SimNow(Stage->State);
+  for (int i = 0; i < 3; ++i) {
+	SimMove *Move = SimAxisMove(Stage->State, i + 3);
+	if (Move != NULL) {
+	  SimSetPosition(*Move, NewAngle[i], tNow);
+	}
+  }
+  SimPublish(Stage);
+  return true;
+}
+//
+// End of initialisation ++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// Motion parameters +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// These set the LINEAR speed and acceleration per axis (assumed to be the same in the
+// accel and decel phases.  Units are  mm/sec and mm/sec2
+// NewAccel and NewSpeed are pointers to double[3] arrays containing the new values for each axis.
+// At present OMDAQ only allows a single accel value for all axes.
+XYZ_DLL bool _CALLSTYLE_ XyzCtxSetAccel(XYZSTAGE Stage, double * NewAccel) {
+  std::lock_guard<std::mutex> lock(Stage->Lock);
+  for (int i = 0; i < 3; ++i) {
+	Stage->LinAccel[i] = NewAccel[i];
+  }
+  return true;
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzCtxSetSpeed(XYZSTAGE Stage, double * NewSpeed) {
+  std::lock_guard<std::mutex> lock(Stage->Lock);
+  for (int i = 0; i < 3; ++i) {
+	Stage->LinSpeed[i] = NewSpeed[i];
+  }
+  return true;
+}
+
+// These set the ROTATIONAL speed and acceleration per axis (assumed to be the same in the
+// accel and decel phases.  Units are  deg/sec and deg/sec2
+// NewAccel and NewSpeed are pointers to double[3] arrays containing the new values for each axis.
+XYZ_DLL bool _CALLSTYLE_ XyzCtxSetRotAccel(XYZSTAGE Stage, double * NewAccel) {
+  // This comment is no longer valid:  OMDAQ DOES set rotary acceleration.
+  ///*  At present OMDAQ does not define rotational acceleration, so this call is not used.
+  // This must be set up during initialisation */
+  //
+  std::lock_guard<std::mutex> lock(Stage->Lock);
+  for (int i = 0; i < 3; ++i) {
+	Stage->RotAccel[i] = NewAccel[i];
+  }
+  return true;
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzCtxSetRotSpeed(XYZSTAGE Stage, double * NewSpeed) {
+  std::lock_guard<std::mutex> lock(Stage->Lock);
+  for (int i = 0; i < 3; ++i) {
+	Stage->RotSpeed[i] = NewSpeed[i];
+  }
+  return true;
+}
+
+// Power On-off.  Turns the power to all axes ON (Enabled = true) or OFF (Enabled = false)
+// Leaves the controller active and reporting.
+// returns true for success.
+XYZ_DLL bool _CALLSTYLE_ XyzCtxPowerOn(XYZSTAGE Stage, bool Enabled) {
+  std::lock_guard<std::mutex> lock(Stage->Lock);
+  Stage->State.DllPowerOn = Enabled;
+  SimPublish(Stage);
+  return true;
+}
+// End of motion parameters +++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// Motion commands. ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Move the position or angle to the absolute values supplied in the arguments.
+// Arguments are pointers to double[3] containing the new values.
+// The routines are expected to return immediately - waiting for position is handled by OMDAQ
+//
+XYZ_DLL bool _CALLSTYLE_ XyzCtxMoveToPosition(XYZSTAGE Stage,
+	double * NewPosition) {
+  std::lock_guard<std::mutex> lock(Stage->Lock);
+  double tNow = SimNow(Stage->State);
+  for (int i = 0; i < 3; ++i) {
+	SimMove *Move = SimAxisMove(Stage->State, i);
+	if (Move != NULL) {
+	  SimStartMove(*Move, NewPosition[i], Stage->LinSpeed[i],
+		  Stage->LinAccel[i], Stage->LinJerk[i], tNow);
+	}
+  }
+  SimPublish(Stage);
+  return true;
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzCtxMoveToAngle(XYZSTAGE Stage, double * NewAngle) {
+  std::lock_guard<std::mutex> lock(Stage->Lock);
+  double tNow = SimNow(Stage->State);
+  for (int i = 0; i < 3; ++i) {
+	SimMove *Move = SimAxisMove(Stage->State, i + 3);
+	if (Move != NULL) {
+	  SimStartMove(*Move, NewAngle[i], Stage->RotSpeed[i],
+		  Stage->RotAccel[i], Stage->RotJerk[i], tNow);
+	}
+  }
+  SimPublish(Stage);
+  return true;
+}
+
+// XyzStop performs an immediate halt (emergency stop, so no deceleration) on all axes
+XYZ_DLL bool _CALLSTYLE_ XyzCtxHalt(XYZSTAGE Stage) {
+  std::lock_guard<std::mutex> lock(Stage->Lock);
+  Stage->State.DllPowerOn = false;
+  double tNow = SimNow(Stage->State);
+  for (int i = 0; i < SimConfig::nDriven; ++i) {
+	SimMove &Move = Stage->State.Move[i];
+	SimSetPosition(Move, SimPosition(Move, tNow), tNow);
+  }
+  SimPublish(Stage);
+  return true;
+}
+//
+// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// Status reporting +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// GetPosition and GetAngle read back the current values into the arguments, which are pointers
+// to double[3].
+XYZ_DLL bool _CALLSTYLE_ XyzCtxGetPosition(XYZSTAGE Stage,
+	double * CurrentPosition) {
+  SimState State = Stage->Published.Read();
+  double tNow = SimNow(State);
+  for (int i = 0; i < 3; ++i) {
+	CurrentPosition[i] = SimAxisPosition(State, i, tNow);
+  }
+  return true;
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzCtxGetAngle(XYZSTAGE Stage, double * CurrentAngle) {
+  SimState State = Stage->Published.Read();
+  double tNow = SimNow(State);
+  for (int i = 0; i < 3; ++i) {
+	CurrentAngle[i] = SimAxisPosition(State, i + 3, tNow);
+  }
+  return true;
+}
+
+//
+// GetMotorTemp returns the temperature in degrees of all axes.
+// MotorTemp is a pointer to a double array
+// if iAxis = -1 this it's an array big enough to hold all motor temps.
+// If iAxis >= 0 the temp of iAxis is put into th efirst element of the array.
+XYZ_DLL bool _CALLSTYLE_ XyzCtxGetMotorTemp(XYZSTAGE Stage, double *MotorTemp,
+	int iAxis) {
+  if (iAxis >= 6) {
+	return false;
+  }
+  SimState State = Stage->Published.Read();
+  double tNow = SimNow(State);
+  int iMin = 0;
+  int iMax = 6;
+  if (iAxis >= 0) {
+	iMin = iAxis;
+	iMax = iAxis + 1;
+  }
+  for (int i = iMin; i < iMax; ++i) {
+	MotorTemp[i - iMin] = SimAxisTemp(State, i, tNow);
+  }
+  return true;
+}
+// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// Status and Error handling commands.  *************************************
+//
+// StageStatus returns the DRVSTAT (UINT64) status mask built
+// from the mask constants defined in OmXyzDll_StatusBits.h.  Optionally the program may ask
+// for more details in the AxisStatus DWORDs by passing a non-NULL pointer to
+// AxisiStstus.  This is DWORD[3] or DWORD[6] depending on the capabilities of the stage.
+// if iAxis = -1 this it's an array big enough to hold all axis status.
+// If iAxis >= 0 the temp of iAxis is put into the first element of the array.
+// Note that for single axis calls only the single axis segments of status are filled
+// so this must be managed in th ecalling program,
+XYZ_DLL DRVSTAT _CALLSTYLE_ XyzCtxStageStatus(XYZSTAGE Stage, DWORD * AxisStatus) {
+  return XyzCtxAxisStatus(Stage, -1, AxisStatus);
+}
+
+XYZ_DLL DRVSTAT _CALLSTYLE_ XyzCtxAxisStatus(XYZSTAGE Stage, int iAxis,
+	DWORD * AxisStatus) {
+  if (iAxis >= 6) {
+	return 0;
+  }
+  SimState State = Stage->Published.Read();
+  return SimStatus(State, SimNow(State), iAxis, AxisStatus);
+}
+
+//
+// XyzFaultAck is called after StageStatus reports a fault - defined as a POSLIM, NEGLIM or HWFAULT
+// on any axis.  This should be used to clear faults (e.g. backing off from limit switches).
+// Return values have the followinhg meanings:
+// XyzFltAckOK    0    // Fault has been cleared OK (as far as I can tell)
+// XyzFltAckFatal 1    // Fault cannot be cleared and the stage is dead
+// (in which case OMDAQ will try to do a tidy shutdown)
+// XyzFtlAckRetry 2    // I may be able to clear the fault if you try again,
+XYZ_DLL int _CALLSTYLE_ XyzCtxFaultAck(XYZSTAGE Stage) {
+  std::lock_guard<std::mutex> lock(Stage->Lock);
+  // Resets the limits in one go
+  double tNow = SimNow(Stage->State);
+  for (int i = 0; i < 6; ++i) {
+	SimMove *Move = SimAxisMove(Stage->State, i);
+	if (Move == NULL) {
+	  continue;
+	}
+	double Position = SimPosition(*Move, tNow);
+	if (Position < -SimLimit[i]) {
+	  SimSetPosition(*Move, -(SimLimit[i] - 0.01), tNow);
+	}
+	if (Position > SimLimit[i]) {
+	  SimSetPosition(*Move, SimLimit[i] - 0.01, tNow);
+	}
+  }
+  SimPublish(Stage);
+  return XyzFltAckOK;
+}
+
+//
+// This call returns a text description of the last HWFAULT encountered
+// The existence of a fault must be signalled in the StageStatus flag mask.
+// nChar is the length of the supplied buffer.    (typically 80 characters)
+//
+// return true for success.
+XYZ_DLL bool _CALLSTYLE_ XyzCtxLastFaultText(XYZSTAGE Stage, char *statusText,
+	int nChar) {
+  strcpy(statusText, "Fault?  What fault?");
+  return true;
+}
+//
+// *************************************************************************
+
+// Extended routines (OmXyzDllExt.h) +++++++++++++++++++++++++++++++++++++++++++
+//
+// XyzCreateStage creates a new simulated stage, independent of the default
+// stage used by the OMDAQ-3 calls.  It must be initialised with
+// XyzCtxInitialise like the default stage.  Returns NULL if out of memory.
+XYZ_DLL XYZSTAGE _CALLSTYLE_ XyzCreateStage() {
+  return new(std::nothrow) XyzStage;
+}
+
+// XyzDestroyStage frees a stage made by XyzCreateStage.  The default stage
+// can't be destroyed, and neither can a stage from its own callback, whose
+// thread still uses the stage when the callback returns.  A callback thread
+// that was detached because its callback removed itself may still be in the
+// callback, so the stage is only freed once all have ended.
+XYZ_DLL bool _CALLSTYLE_ XyzDestroyStage(XYZSTAGE Stage) {
+  if (Stage == NULL || Stage == &DefaultStage || SimInCallback(Stage)) {
+	return false;
+  }
+  XyzCtxShutDown(Stage);
+  std::unique_lock<std::mutex> lock(Stage->Lock);
+  while (Stage->CallbackThreads > 0) {
+	// A callback may have set a new callback meanwhile.
+	if (Stage->CallbackThread.joinable()) {
+	  lock.unlock();
+	  SimStopCallback(Stage);
+	  lock.lock();
+	  continue;
+	}
+	Stage->CallbackEnded.wait(lock);
+  }
+  lock.unlock();
+  delete Stage;
+  return true;
+}
+
+// XyzCtxSimSetTimeSource replaces the clock used to simulate Stage.  NULL
+// restores the monotonic clock.  The stage is stopped where it is, because
+// positions and times of the current moves are not valid with the new clock.
+XYZ_DLL bool _CALLSTYLE_ XyzCtxSimSetTimeSource(XYZSTAGE Stage,
+	XyzTimeSource Source) {
+  std::lock_guard<std::mutex> lock(Stage->Lock);
+  double tNow = SimNow(Stage->State);
+  double Position[SimConfig::nDriven];
+  for (int i = 0; i < SimConfig::nDriven; ++i) {
+	Position[i] = SimPosition(Stage->State.Move[i], tNow);
+  }
+  Stage->State.Source = Source;
+  Stage->State.ClockMode = XyzClockReal;
+  Stage->State.ClockOrigin = 0;
+  Stage->State.ClockRealOrigin = 0;
+  Stage->State.ClockScale = 1;
+  tNow = SimNow(Stage->State);
+  for (int i = 0; i < SimConfig::nDriven; ++i) {
+	SimSetPosition(Stage->State.Move[i], Position[i], tNow);
+  }
+  SimPublish(Stage);
+  return true;
+}
+
+// XyzCtxSimSetClockMode selects the clock of the simulation: XyzClockReal,
+// XyzClockVirtual or XyzClockScaled (real time multiplied by Scale).
+// The simulated time carries on from its current value, so moves in progress
+// are not disturbed.
+XYZ_DLL bool _CALLSTYLE_ XyzCtxSimSetClockMode(XYZSTAGE Stage, int Mode,
+	double Scale) {
+  std::lock_guard<std::mutex> lock(Stage->Lock);
+  double tNow = SimNow(Stage->State);
+  switch (Mode) {
+  case XyzClockReal:
+	Scale = 1;
+	break;
+  case XyzClockVirtual:
+	Stage->State.VirtualNow = tNow;
+	Stage->State.Source = NULL;
+	Stage->State.ClockMode = XyzClockVirtual;
+	SimPublish(Stage);
+	return true;
+  case XyzClockScaled:
+	if (Scale <= 0) {
+	  return false;
+	}
+	break;
+  default:
+	return false;
+  }
+  Stage->State.ClockOrigin = tNow;
+  Stage->State.ClockRealOrigin = MonotonicTime();
+  Stage->State.ClockScale = Scale;
+  Stage->State.Source = NULL;
+  Stage->State.ClockMode = Mode;
+  SimPublish(Stage);
+  return true;
+}
+
+// XyzCtxSimAdvanceClock moves the virtual clock forward by Seconds.
+XYZ_DLL bool _CALLSTYLE_ XyzCtxSimAdvanceClock(XYZSTAGE Stage, double Seconds) {
+  std::lock_guard<std::mutex> lock(Stage->Lock);
+  if (Stage->State.Source != NULL ||
+	  Stage->State.ClockMode != XyzClockVirtual || Seconds < 0) {
+	return false;
+  }
+  Stage->State.VirtualNow += Seconds;
+  SimPublish(Stage);
+  return true;
+}
+
+// XyzCtxSimSetJerk sets the jerk limit (mm/s3 and deg/s3) of each axis for the
+// following moves.  0 means no limit (trapezoidal profile).
+XYZ_DLL bool _CALLSTYLE_ XyzCtxSimSetJerk(XYZSTAGE Stage, double *NewLinJerk,
+	double *NewRotJerk) {
+  std::lock_guard<std::mutex> lock(Stage->Lock);
+  for (int i = 0; i < 3; ++i) {
+	Stage->LinJerk[i] = NewLinJerk[i];
+	Stage->RotJerk[i] = NewRotJerk[i];
+  }
+  return true;
+}
+
+// XyzCtxSimTimeToGo returns the time (s) left until each axis reaches the end of
+// its current move, 0 for axes at rest.
+XYZ_DLL bool _CALLSTYLE_ XyzCtxSimTimeToGo(XYZSTAGE Stage, double *LinTime,
+	double *RotTime) {
+  SimState State = Stage->Published.Read();
+  double tNow = SimNow(State);
+  for (int i = 0; i < 6; ++i) {
+	const SimMove *Move = SimAxisMove(State, i);
+	double Time = (Move != NULL) ? fmax(SimEndTime(*Move) - tNow, 0.0) : 0;
+	if (i < 3) {
+	  LinTime[i] = Time;
+	}
+	else {
+	  RotTime[i - 3] = Time;
+	}
+  }
+  return true;
+}
+
+// XyzCtxSimGetTime returns the current simulation time in seconds.
+XYZ_DLL bool _CALLSTYLE_ XyzCtxSimGetTime(XYZSTAGE Stage, double *Seconds) {
+  SimState State = Stage->Published.Read();
+  *Seconds = SimNow(State);
+  return true;
+}
+// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// Stage snapshot +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//
+// XyzCtxGetSnapshot fills Snapshot from one reading of the published state,
+// all evaluated at the same simulation time.
+XYZ_DLL bool _CALLSTYLE_ XyzCtxGetSnapshot(XYZSTAGE Stage,
+	struct XyzSnapshot *Snapshot) {
+  SimState State = Stage->Published.Read();
+  SimSnapshot(State, SimNow(State), Snapshot);
+  return true;
+}
+// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// Status polling +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//
+// XyzCtxStatusDelta.  The generation is the number of states published (see
+// SeqLock).  The status only changes without a new state while an axis is
+// moving, so the status is only worked out if the generation changed or if
+// an axis was moving.
+XYZ_DLL bool _CALLSTYLE_ XyzCtxStatusDelta(XYZSTAGE Stage,
+	unsigned *Generation, DRVSTAT *Status, DRVSTAT *Changed,
+	int *ChangedAxes) {
+  *Changed = 0;
+  *ChangedAxes = 0;
+  if (Stage->Published.Generation() == *Generation &&
+	  (*Status & (ST_ANY_XYZ_MOVING | ST_ANY_R3_MOVING)) == 0) {
+	return false;
+  }
+  SimState State = Stage->Published.Read(Generation);
+  DRVSTAT NewStatus = SimStatus(State, SimNow(State), -1, NULL);
+  *Changed = NewStatus ^ *Status;
+  *Status = NewStatus;
+  for (int i = 0; i < 6; ++i) {
+	*ChangedAxes |= (int)(((*Changed >> XyzStatusShift[i]) & 0xFF) != 0) << i;
+  }
+  return *Changed != 0;
+}
+
+// XyzCtxWaitStatusChange sleeps until a new state is published or until the
+// simulation clock gets to the next time the status can change by itself
+// (see SimNextChange), and then checks the status again.
+XYZ_DLL bool _CALLSTYLE_ XyzCtxWaitStatusChange(XYZSTAGE Stage, DRVSTAT Mask,
+	int Timeout, DRVSTAT *Status) {
+  std::chrono::steady_clock::time_point Deadline =
+	  std::chrono::steady_clock::now() + std::chrono::milliseconds(Timeout);
+  std::unique_lock<std::mutex> lock(Stage->Lock);
+  DRVSTAT Start = SimStatus(Stage->State, SimNow(Stage->State), -1, NULL);
+  DRVSTAT NewStatus = Start;
+  bool Changed = false;
+  for (;;) {
+	double tNow = SimNow(Stage->State);
+	NewStatus = SimStatus(Stage->State, tNow, -1, NULL);
+	Changed = ((NewStatus ^ Start) & Mask) != 0;
+	std::chrono::steady_clock::time_point RealNow =
+		std::chrono::steady_clock::now();
+	if (Changed || RealNow >= Deadline) {
+	  break;
+	}
+	std::chrono::steady_clock::time_point Wake = Deadline;
+	double Delay = SimRealDelay(Stage->State, tNow,
+		SimNextChange(Stage->State, tNow));
+	if (Delay < std::chrono::duration<double>(Deadline - RealNow).count()) {
+	  Wake = RealNow + std::chrono::duration_cast<
+		  std::chrono::steady_clock::duration>(
+		  std::chrono::duration<double>(Delay));
+	}
+	Stage->StatusChanged.wait_until(lock, Wake);
+  }
+  if (Status != NULL) {
+	*Status = NewStatus;
+  }
+  return Changed;
+}
+// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// Motion callback ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//
+// XyzCtxSetMotionCallback starts the callback thread of the stage (see
+// SimCallbackWorker) when the first callback is set and stops it when the
+// callback is removed.
+XYZ_DLL bool _CALLSTYLE_ XyzCtxSetMotionCallback(XYZSTAGE Stage,
+	XyzMotionCallback Callback, void *User) {
+  if (Callback == NULL) {
+	SimStopCallback(Stage);
+	return true;
+  }
+  std::lock_guard<std::mutex> lock(Stage->Lock);
+  Stage->Callback = Callback;
+  Stage->CallbackUser = User;
+  if (!Stage->CallbackThread.joinable()) {
+	Stage->CallbackThread = std::thread(SimCallbackWorker, Stage);
+	++Stage->CallbackThreads;
+  }
+  return true;
+}
+// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// OMDAQ-3 calls on the default stage ++++++++++++++++++++++++++++++++++++++++++
+//
+XYZ_DLL bool _CALLSTYLE_ XyzOptionValue(int nHdr, char * optionVal,
+	int szOptionVal) {
+  return XyzCtxOptionValue(&DefaultStage, nHdr, optionVal, szOptionVal);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzInitialise(char **options, int szOptions) {
+  return XyzCtxInitialise(&DefaultStage, options, szOptions);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzShutDown() {
+  return XyzCtxShutDown(&DefaultStage);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzSetCurrentPosition(double * NewPosition) {
+  return XyzCtxSetCurrentPosition(&DefaultStage, NewPosition);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzSetCurrentAngle(double * NewAngle) {
+  return XyzCtxSetCurrentAngle(&DefaultStage, NewAngle);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzSetAccel(double * NewAccel) {
+  return XyzCtxSetAccel(&DefaultStage, NewAccel);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzSetSpeed(double * NewSpeed) {
+  return XyzCtxSetSpeed(&DefaultStage, NewSpeed);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzSetRotAccel(double * NewAccel) {
+  return XyzCtxSetRotAccel(&DefaultStage, NewAccel);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzSetRotSpeed(double * NewSpeed) {
+  return XyzCtxSetRotSpeed(&DefaultStage, NewSpeed);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzPowerOn(bool Enabled) {
+  return XyzCtxPowerOn(&DefaultStage, Enabled);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzMoveToPosition(double * NewPosition) {
+  return XyzCtxMoveToPosition(&DefaultStage, NewPosition);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzMoveToAngle(double * NewAngle) {
+  return XyzCtxMoveToAngle(&DefaultStage, NewAngle);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzHalt() {
+  return XyzCtxHalt(&DefaultStage);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzGetPosition(double * CurrentPosition) {
+  return XyzCtxGetPosition(&DefaultStage, CurrentPosition);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzGetAngle(double * CurrentAngle) {
+  return XyzCtxGetAngle(&DefaultStage, CurrentAngle);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzGetMotorTemp(double *MotorTemp, int iAxis) {
+  return XyzCtxGetMotorTemp(&DefaultStage, MotorTemp, iAxis);
+}
+
+XYZ_DLL DRVSTAT _CALLSTYLE_ XyzStageStatus(DWORD * AxisStatus) {
+  return XyzCtxStageStatus(&DefaultStage, AxisStatus);
+}
+
+XYZ_DLL DRVSTAT _CALLSTYLE_ XyzAxisStatus(int iAxis, DWORD * AxisStatus) {
+  return XyzCtxAxisStatus(&DefaultStage, iAxis, AxisStatus);
+}
+
+XYZ_DLL int _CALLSTYLE_ XyzFaultAck() {
+  return XyzCtxFaultAck(&DefaultStage);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzLastFaultText(char *statusText, int nChar) {
+  return XyzCtxLastFaultText(&DefaultStage, statusText, nChar);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzSimSetTimeSource(XyzTimeSource Source) {
+  return XyzCtxSimSetTimeSource(&DefaultStage, Source);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzSimSetClockMode(int Mode, double Scale) {
+  return XyzCtxSimSetClockMode(&DefaultStage, Mode, Scale);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzSimAdvanceClock(double Seconds) {
+  return XyzCtxSimAdvanceClock(&DefaultStage, Seconds);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzSimSetJerk(double *NewLinJerk, double *NewRotJerk) {
+  return XyzCtxSimSetJerk(&DefaultStage, NewLinJerk, NewRotJerk);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzSimTimeToGo(double *LinTime, double *RotTime) {
+  return XyzCtxSimTimeToGo(&DefaultStage, LinTime, RotTime);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzSimGetTime(double *Seconds) {
+  return XyzCtxSimGetTime(&DefaultStage, Seconds);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzGetSnapshot(struct XyzSnapshot *Snapshot) {
+  return XyzCtxGetSnapshot(&DefaultStage, Snapshot);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzStatusDelta(unsigned *Generation, DRVSTAT *Status,
+	DRVSTAT *Changed, int *ChangedAxes) {
+  return XyzCtxStatusDelta(&DefaultStage, Generation, Status, Changed,
+	  ChangedAxes);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzWaitStatusChange(DRVSTAT Mask, int Timeout,
+	DRVSTAT *Status) {
+  return XyzCtxWaitStatusChange(&DefaultStage, Mask, Timeout, Status);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzSetMotionCallback(XyzMotionCallback Callback,
+	void *User) {
+  return XyzCtxSetMotionCallback(&DefaultStage, Callback, User);
+}
+// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
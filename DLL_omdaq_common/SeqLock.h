@@ -0,0 +1,78 @@
+///--------------------------------------------------------------------------
+// SEQLOCK.H
+// Sequence lock used to publish the state of a stage to the status calls
+// (XyzGetPosition, XyzAxisStatus, ...), which OMDAQ makes from a different
+// thread than the moves.  Shared by the simulators and the tomography DLL.
+//
+// The writer copies the whole state in with Write and readers get a copy
+// with Read.  Readers never block the writer: a reader that overlaps a write
+// sees the sequence number change and reads again, so it never sees a torn
+// state.  Writes must not overlap (writers hold the stage mutex).
+// T must be trivially copyable.  It is stored as atomic words so that the
+// copies are well defined while a write is in progress.
+// ---------------------------------------------------------------------------
+
+#ifndef SeqLockH
+#define SeqLockH
+
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+template <class T> class SeqLock {
+  static_assert(std::is_trivially_copyable<T>::value,
+	  "SeqLock needs a trivially copyable type");
+  static const size_t nWords = (sizeof(T) + sizeof(unsigned long long) - 1) /
+	  sizeof(unsigned long long);
+  std::atomic<unsigned> Seq;
+  std::atomic<unsigned long long> Words[nWords];
+
+public:
+  SeqLock() : Seq(0) {
+	T Empty = T();
+	Write(Empty);
+  }
+
+  // Publishes Value.  Only one thread may write at a time.
+  void Write(const T &Value) {
+	unsigned long long Buffer[nWords] = {};
+	memcpy(Buffer, &Value, sizeof(T));
+	unsigned s = Seq.load(std::memory_order_relaxed);
+	Seq.store(s + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	for (size_t i = 0; i < nWords; ++i) {
+	  Words[i].store(Buffer[i], std::memory_order_relaxed);
+	}
+	Seq.store(s + 2, std::memory_order_release);
+  }
+
+  // Returns the last value published, and its generation in Gen if
+  // not NULL.  Never blocks, but retries while a write is in progress.
+  T Read(unsigned *Gen = NULL) const {
+	unsigned long long Buffer[nWords];
+	unsigned s1, s2;
+	do {
+	  s1 = Seq.load(std::memory_order_acquire);
+	  for (size_t i = 0; i < nWords; ++i) {
+		Buffer[i] = Words[i].load(std::memory_order_relaxed);
+	  }
+	  std::atomic_thread_fence(std::memory_order_acquire);
+	  s2 = Seq.load(std::memory_order_relaxed);
+	} while ((s1 & 1) != 0 || s1 != s2);
+	T Value;
+	memcpy(&Value, Buffer, sizeof(T));
+	if (Gen != NULL) {
+	  *Gen = s1 / 2;
+	}
+	return Value;
+  }
+
+  // Number of values published so far.  It changes with every Write, so a
+  // reader can tell whether anything was published since its last Read
+  // without reading the value.
+  unsigned Generation() const {
+	return Seq.load(std::memory_order_acquire) / 2;
+  }
+};
+
+#endif
@@ -0,0 +1,81 @@
+///--------------------------------------------------------------------------
+// XYZSTAGECONFIG.H
+// Compile-time description of the axes of a stage, shared by the simulated
+// and the real stage DLLs.  Needs C++14 (std::make_integer_sequence).
+//
+// XyzStageConfig<nLin, nRot, Options, Driven> is a stage with nLin (0 or 3)
+// linear and nRot (0 to 3) rotation axes reported to OMDAQ.  Options are the
+// other XYZCAP_ flags (power switching, temperature sensors, home switches).
+// Driven has bit i set for each axis i that the DLL really moves, by default
+// all the reported axes.  Axes are numbered as in XyzStatusShift: 0 to 2
+// linear, 3 to 5 rotation.  Axes that are reported but not driven are always
+// in position, e.g. the linear axes OMDAQ-3 needs on a rotation-only stage.
+//
+// The state of the driven axes can be kept in arrays of nDriven elements,
+// the element of axis i being Slot(i).
+//
+// ForEachAxis calls a function for each of the six axes with the axis number
+// as a std::integral_constant.  The loop is unrolled and the tests on the
+// configuration are constants, so no code is generated for missing axes.
+// OmXyzDll.h and XyzStatusLayout.h (included by OmXyzDllExt.h) must be
+// included before this file.
+// ---------------------------------------------------------------------------
+
+#ifndef XyzStageConfigH
+#define XyzStageConfigH
+
+#include <type_traits>
+#include <utility>
+
+// Bits of axes 0 to nLin - 1 and 3 to 3 + nRot - 1
+constexpr unsigned XyzAxisBits(int nLin, int nRot) {
+  return ((1u << nLin) - 1) | ((1u << nRot) - 1) << 3;
+}
+
+// Number of bits set in Bits
+constexpr int XyzBitCount(unsigned Bits) {
+  return (Bits == 0) ? 0 : (int)(Bits & 1) + XyzBitCount(Bits >> 1);
+}
+
+template <int nLin, int nRot, DWORD Options = 0,
+	unsigned Driven = XyzAxisBits(nLin, nRot)>
+struct XyzStageConfig {
+  static_assert(nLin == 0 || nLin == 3, "Linear axes come as XYZ3");
+  static_assert(nRot >= 0 && nRot <= 3, "At most 3 rotation axes");
+  static_assert((Driven & ~XyzAxisBits(nLin, nRot)) == 0,
+	  "Driven axes must be reported");
+
+  static const unsigned ReportedAxes = XyzAxisBits(nLin, nRot);
+  static const unsigned DrivenAxes = Driven;
+  static const int nDriven = XyzBitCount(Driven);
+
+  // The XyzCapabilityMask of the stage
+  static const DWORD CapabilityMask = (nLin == 3 ? XYZCAP_XYZ3 : 0) |
+	  (nRot == 1 ? XYZCAP_ROT1 : 0) | (nRot == 2 ? XYZCAP_ROT2 : 0) |
+	  (nRot == 3 ? XYZCAP_ROT3 : 0) | Options;
+
+  static constexpr bool Reported(int iAxis) {
+	return ((ReportedAxes >> iAxis) & 1) != 0;
+  }
+  static constexpr bool IsDriven(int iAxis) {
+	return ((DrivenAxes >> iAxis) & 1) != 0;
+  }
+  // Index of driven axis iAxis among the driven axes
+  static constexpr int Slot(int iAxis) {
+	return XyzBitCount(DrivenAxes & ((1u << iAxis) - 1));
+  }
+
+  // Calls f(std::integral_constant<int, i>()) for i = 0 to 5.
+  template <class F> static void ForEachAxis(F f) {
+	ForEach(f, std::make_integer_sequence<int, 6>());
+  }
+
+private:
+  template <class F, int... i>
+  static void ForEach(F &f, std::integer_sequence<int, i...>) {
+	int Expand[] = {(f(std::integral_constant<int, i>()), 0)...};
+	(void)Expand;
+  }
+};
+
+#endif
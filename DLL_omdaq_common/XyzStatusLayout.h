@@ -0,0 +1,80 @@
+///--------------------------------------------------------------------------
+// XYZSTATUSLAYOUT.H
+// Status layout shared by the stage DLLs: the bytes of the axes in the
+// DRVSTAT mask, the axis detail words, the stage snapshot and the motion
+// callback.  Included by the OmXyzDllExt.h of each DLL, which adds the calls
+// of the DLL.
+// OmXyzDll.h must be included before this file.
+// ---------------------------------------------------------------------------
+
+#ifndef XyzStatusLayoutH
+#define XyzStatusLayoutH
+
+// Layout of the status bits.  The bits of each axis in OmXyzDll_StatusBits.h
+// take one byte of the DRVSTAT mask, axes AX1, AX2, AX3, RO1, RO2, RO3 from
+// the low end.  XyzStatusShift[i] is the position of the byte of axis i
+// (0 to 5) and the XyzSt flags are the bits inside the byte, so that e.g.
+// XyzAxisFlags(3, XyzStMoving) == ST_RO1_MOVING.
+#ifdef __cplusplus
+constexpr int XyzStatusShift[6] = {8, 16, 24, 32, 40, 48};
+constexpr DRVSTAT XyzStMoving     = ST_AX1_MOVING >> 8;
+constexpr DRVSTAT XyzStPosLim     = ST_AX1_POSLIM >> 8;
+constexpr DRVSTAT XyzStNegLim     = ST_AX1_NEGLIM >> 8;
+constexpr DRVSTAT XyzStInPosition = ST_AX1_INPOSITION >> 8;
+constexpr DRVSTAT XyzStMotorOn    = ST_AX1_MOTOR_ON >> 8;
+constexpr DRVSTAT XyzStHwFault    = ST_AX1_HWFAULT >> 8;
+constexpr DRVSTAT XyzStOverTemp   = ST_AX1_OVERTEMP >> 8;
+
+constexpr DRVSTAT XyzAxisFlags(int iAxis, DRVSTAT Flags) {
+  return Flags << XyzStatusShift[iAxis];
+}
+
+static_assert(XyzAxisFlags(1, XyzStInPosition) == ST_AX2_INPOSITION &&
+	XyzAxisFlags(2, XyzStNegLim) == ST_AX3_NEGLIM &&
+	XyzAxisFlags(3, XyzStMoving) == ST_RO1_MOVING &&
+	XyzAxisFlags(4, XyzStPosLim) == ST_RO2_POSLIM &&
+	XyzAxisFlags(5, XyzStOverTemp) == ST_RO3_OVERTEMP,
+	"Status bits don't follow the one byte per axis layout");
+#endif
+
+// Axis detail words.  If XyzAxisStatus or XyzStageStatus are given an
+// AxisStatus array, each axis reported gets a DWORD made of these flags (the
+// set that OmXyzDll_StatusBits.h keeps commented out).  With iAxis = -1 axes
+// 0 to 5 go to AxisStatus[0] to [5]; a single axis goes to AxisStatus[0].
+// While an axis moves exactly one of AX_ACCEL, AX_CONST_SPEED and AX_DECEL
+// is set, the phase of the motion profile.
+#define AX_MISSING               0x01   // Axis missing
+#define AX_MOTOR_ON              0x02   // Motor on
+#define AX_ACTIVE                0x04   // Axis active
+#define AX_MOVING                0x08   // Axis moving
+#define AX_INFINITE_MOVE         0x10   // Permanent motion
+#define AX_FOLLOWING             0x20   // Following error
+#define AX_ACCEL                 0x40   // Acceleration phase
+#define AX_DECEL                 0x80   // Deceleration phase
+#define AX_REF_HOME             0x100   // Referenced to home
+#define AX_NEG_LIMIT            0x200   // Neg limit active
+#define AX_POS_LIMIT            0x400   // Pos limit active
+#define AX_CONST_SPEED          0x800   // Constant speed phase
+#define AX_SYNC                0x1000   // Axis synchronised
+
+// The state of the whole stage at one time, see XyzGetSnapshot.  Time is the
+// time (s) of the state, on the clock of the DLL (see its OmXyzDllExt.h).
+// Status and AxisStatus are as returned by XyzStageStatus.
+struct XyzSnapshot {
+  double Time;
+  double Position[3];
+  double Angle[3];
+  double MotorTemp[6];
+  DRVSTAT Status;
+  DWORD AxisStatus[6];
+};
+
+// Called by the stage when axes reach their target, hit a limit or fault,
+// see XyzSetMotionCallback.  Events holds the status bits of XyzMotionEvents
+// that have just been set and Snapshot the state of the stage at that time.
+typedef void (_CALLSTYLE_ *XyzMotionCallback)(void *User, DRVSTAT Events,
+	const struct XyzSnapshot *Snapshot);
+#define XyzMotionEvents (ST_ANY_XYZ_INPOSITION | ST_ANY_R3_INPOSITION | \
+	ST_ANY_XYZ_LIMIT | ST_ANY_R3_LIMIT | ST_ANY_XYZ_HWFAULT | ST_ANY_R3_HWFAULT)
+
+#endif
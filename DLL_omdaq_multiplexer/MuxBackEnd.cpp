@@ -0,0 +1,97 @@
+// ---------------------------------------------------------------------------
+//
+// Loading of the back-end DLLs of the multiplexer, see MuxBackEnd.h.
+//
+// ---------------------------------------------------------------------------
+#pragma hdrstop
+#include <string.h>
+#include <string>
+
+#include "OmXyzDll.h"
+#include "MuxBackEnd.h"
+
+#ifndef _WIN32
+#include <dlfcn.h>
+#endif
+// ---------------------------------------------------------------------------
+#pragma package(smart_init)
+
+// Address of routine Name in Module, NULL if it isn't there.  32-bit C++
+// Builder exports __cdecl routines with a leading underscore, so that name
+// is tried too.
+void *MuxFindRoutine(void *Module, const char *Name) {
+  std::string Decorated = std::string("_") + Name;
+#ifdef _WIN32
+  FARPROC Routine = GetProcAddress((HMODULE)Module, Name);
+  if (Routine == NULL) {
+	Routine = GetProcAddress((HMODULE)Module, Decorated.c_str());
+  }
+  return (void *)Routine;
+#else
+  void *Routine = dlsym(Module, Name);
+  if (Routine == NULL) {
+	Routine = dlsym(Module, Decorated.c_str());
+  }
+  return Routine;
+#endif
+}
+
+// Sets Pointer to routine Name of Module.  Returns false if it isn't there.
+template <class T> bool MuxFind(void *Module, T &Pointer, const char *Name) {
+  Pointer = (T)MuxFindRoutine(Module, Name);
+  return Pointer != NULL;
+}
+
+bool MuxLoadBackEnd(MuxBackEnd *BackEnd, const char *Path) {
+  memset(BackEnd, 0, sizeof(MuxBackEnd));
+#ifdef _WIN32
+  void *Module = (void *)LoadLibraryA(Path);
+#else
+  void *Module = dlopen(Path, RTLD_NOW | RTLD_LOCAL);
+#endif
+  if (Module == NULL) {
+	return false;
+  }
+  BackEnd->Module = Module;
+
+  // Optional routines
+  MuxFind(Module, BackEnd->SetParameterFileName, "XyzSetParameterFileName");
+  MuxFind(Module, BackEnd->SetDLLfolder, "XyzSetDLLfolder");
+  MuxFind(Module, BackEnd->GetMotorTemp, "XyzGetMotorTemp");
+
+  bool ok = MuxFind(Module, BackEnd->CapabilityMask, "XyzCapabilityMask") &
+	  MuxFind(Module, BackEnd->OptionCount, "XyzOptionCount") &
+	  MuxFind(Module, BackEnd->OptionValue, "XyzOptionValue") &
+	  MuxFind(Module, BackEnd->Initialise, "XyzInitialise") &
+	  MuxFind(Module, BackEnd->ShutDown, "XyzShutDown") &
+	  MuxFind(Module, BackEnd->SetCurrentPosition, "XyzSetCurrentPosition") &
+	  MuxFind(Module, BackEnd->SetCurrentAngle, "XyzSetCurrentAngle") &
+	  MuxFind(Module, BackEnd->SetAccel, "XyzSetAccel") &
+	  MuxFind(Module, BackEnd->SetSpeed, "XyzSetSpeed") &
+	  MuxFind(Module, BackEnd->SetRotAccel, "XyzSetRotAccel") &
+	  MuxFind(Module, BackEnd->SetRotSpeed, "XyzSetRotSpeed") &
+	  MuxFind(Module, BackEnd->PowerOn, "XyzPowerOn") &
+	  MuxFind(Module, BackEnd->MoveToPosition, "XyzMoveToPosition") &
+	  MuxFind(Module, BackEnd->MoveToAngle, "XyzMoveToAngle") &
+	  MuxFind(Module, BackEnd->Halt, "XyzHalt") &
+	  MuxFind(Module, BackEnd->GetPosition, "XyzGetPosition") &
+	  MuxFind(Module, BackEnd->GetAngle, "XyzGetAngle") &
+	  MuxFind(Module, BackEnd->AxisStatus, "XyzAxisStatus") &
+	  MuxFind(Module, BackEnd->FaultAck, "XyzFaultAck") &
+	  MuxFind(Module, BackEnd->LastFaultText, "XyzLastFaultText");
+  if (!ok) {
+	MuxFreeBackEnd(BackEnd);
+  }
+  return ok;
+}
+
+void MuxFreeBackEnd(MuxBackEnd *BackEnd) {
+  if (BackEnd->Module != NULL) {
+#ifdef _WIN32
+	FreeLibrary((HMODULE)BackEnd->Module);
+#else
+	dlclose(BackEnd->Module);
+#endif
+  }
+  memset(BackEnd, 0, sizeof(MuxBackEnd));
+}
@@ -0,0 +1,51 @@
+///--------------------------------------------------------------------------
+// MUXBACKEND.H
+// A stage DLL used as a back-end by the multiplexer: the DLL is loaded at run
+// time and its OMDAQ-3 routines (OmXyzDll.h) are called through the pointers
+// below.
+//
+// MuxLoadBackEnd loads the DLL at Path and finds its routines.  It returns
+// false if the DLL can't be loaded or one of the routines OMDAQ-3 requires
+// is missing.  SetParameterFileName, SetDLLfolder and GetMotorTemp came later
+// in OMDAQ-3 and are NULL if the DLL doesn't have them.  MuxFreeBackEnd
+// unloads the DLL.
+//
+// Windows loads the DLL with LoadLibrary, other systems (test builds) with
+// dlopen.
+// ---------------------------------------------------------------------------
+
+#ifndef MuxBackEndH
+#define MuxBackEndH
+
+struct MuxBackEnd {
+  void *Module;
+  DWORD (_CALLSTYLE_ *CapabilityMask)();
+  bool (_CALLSTYLE_ *SetParameterFileName)(wchar_t *cText, int nChar);
+  bool (_CALLSTYLE_ *SetDLLfolder)(wchar_t *statusText, int nChar);
+  int (_CALLSTYLE_ *OptionCount)();
+  bool (_CALLSTYLE_ *OptionValue)(int nHdr, char *optionValue,
+	  int szOptionValue);
+  bool (_CALLSTYLE_ *Initialise)(char **options, int szOptions);
+  bool (_CALLSTYLE_ *ShutDown)();
+  bool (_CALLSTYLE_ *SetCurrentPosition)(double *NewPosition);
+  bool (_CALLSTYLE_ *SetCurrentAngle)(double *NewAngle);
+  bool (_CALLSTYLE_ *SetAccel)(double *NewAccel);
+  bool (_CALLSTYLE_ *SetSpeed)(double *NewSpeed);
+  bool (_CALLSTYLE_ *SetRotAccel)(double *NewAccel);
+  bool (_CALLSTYLE_ *SetRotSpeed)(double *NewSpeed);
+  bool (_CALLSTYLE_ *PowerOn)(bool Enabled);
+  bool (_CALLSTYLE_ *MoveToPosition)(double *NewPosition);
+  bool (_CALLSTYLE_ *MoveToAngle)(double *NewAngle);
+  bool (_CALLSTYLE_ *Halt)();
+  bool (_CALLSTYLE_ *GetPosition)(double *CurrentPosition);
+  bool (_CALLSTYLE_ *GetAngle)(double *CurrentAngle);
+  bool (_CALLSTYLE_ *GetMotorTemp)(double *MotorTemp, int iAxis);
+  DRVSTAT (_CALLSTYLE_ *AxisStatus)(int iAxis, DWORD *AxisStatus);
+  int (_CALLSTYLE_ *FaultAck)();
+  bool (_CALLSTYLE_ *LastFaultText)(char *statusText, int nChar);
+};
+
+bool MuxLoadBackEnd(MuxBackEnd *BackEnd, const char *Path);
+void MuxFreeBackEnd(MuxBackEnd *BackEnd);
+
+#endif
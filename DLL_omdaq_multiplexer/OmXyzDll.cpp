@@ -0,0 +1,651 @@
+// ---------------------------------------------------------------------------
+//
+// This file contains the multiplexer: a stage DLL that makes one OMDAQ-3
+// stage out of two stage DLLs (back-ends), e.g. the linear axes from the DLL
+// of one controller and the rotation axis from the V8849 tomography DLL.
+//
+// The linear axes (XyzMoveToPosition, XyzGetPosition, XyzSetSpeed, ...) go to
+// the linear back-end and the rotation axes to the rotary one.  The same DLL
+// can be both.  Each back-end has its own move worker, so the two
+// controllers move at the same time and a slow one doesn't hold up the other
+// or OMDAQ.  The status of each axis comes from its back-end.
+//
+// ---------------------------------------------------------------------------
+#pragma hdrstop
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define XYZDLL_EXPORTS 1
+#include "OmXyzDll.h"
+#include "OmXyzDllExt.h"
+#include "../DLL_omdaq_common/XyzStageConfig.h"
+#include "MuxBackEnd.h"
+// ---------------------------------------------------------------------------
+#pragma package(smart_init)
+
+// ______Multiplexer state______________________________________
+//
+// The composite stage as OMDAQ-3 sees it: XYZ + 1 rotation with power
+// switching (see XyzStageConfig.h).  Change it to match the back-ends.
+typedef XyzStageConfig<3, 1, XYZCAP_POWER_ONOFF> MuxConfig;
+
+// Roles of the back-ends.  MuxLinear drives axes 0 to 2 and MuxRotary axes
+// 3 to 5, so the role of axis i is i / 3.
+#define MuxLinear 0
+#define MuxRotary 1
+
+// Options: the DLL and the options of each role.  The options of a back-end
+// are given in one string separated by ';', e.g. "COM4;9600".  Missing ones
+// take the default value of the back-end (XyzOptionValue).  If both roles
+// name the same DLL it is loaded once with the linear options, so the rotary
+// options must then be empty or the same (XyzInitialise fails otherwise).
+#define nOptions 4
+#define MuxOptionLength 256
+
+// A back-end DLL and its move worker (see MuxWorker).  Target[r] is the
+// last target of role r and Pending[r] is set until the worker has taken it.
+// Running[r] is set while the worker is passing it on.  Fault[r] is set if
+// the back-end refused it, until XyzFaultAck.  All but Routines are
+// protected by Lock.
+struct MuxDriver {
+  MuxBackEnd Routines = {};
+  int Options = 0;
+  std::thread Worker;
+  std::mutex Lock;
+  std::condition_variable Wake;
+  bool Quit = false;
+  bool Pending[2] = {};
+  bool Running[2] = {};
+  bool Fault[2] = {};
+  double Target[2][3] = {};
+  char FaultText[80] = {};
+};
+
+// Drivers[0 .. nDrivers - 1] are the back-ends loaded by XyzInitialise and
+// Role[r] the one of role r (NULL if none, the same one for both roles if
+// they name the same DLL).  They only change in XyzInitialise, which OMDAQ
+// calls before using the stage.
+struct MuxStage {
+  MuxDriver Drivers[2];
+  int nDrivers = 0;
+  MuxDriver *Role[2] = {NULL, NULL};
+  bool PowerOn = false;
+  char OptionText[nOptions][MuxOptionLength] = {};
+  bool optionsCopied = false;
+  std::wstring ParameterFile;
+  std::wstring DllFolder;
+};
+
+MuxStage Mux;
+//
+// _____________________________________________________________
+
+// Flags of each reported axis of Role, shifted into the byte of the axis
+// (see XyzStatusShift).  MuxRoleBits(Role, 0xFF) is the mask of the status
+// bits of the role.
+constexpr DRVSTAT MuxRoleBits(int Role, DRVSTAT Flags, int i = 0) {
+  return (i == 6) ? 0 : ((i / 3 == Role && MuxConfig::Reported(i)) ?
+	  XyzAxisFlags(i, Flags) : 0) | MuxRoleBits(Role, Flags, i + 1);
+}
+
+// Calls Call(Driver) for every back-end at the same time, the first one on
+// this thread and the second one on a thread of its own, and waits for both.
+// Returns true if all the calls returned true.
+template <class F> bool MuxForEach(F Call) {
+  std::future<bool> Other;
+  if (Mux.nDrivers > 1) {
+	Other = std::async(std::launch::async, Call, &Mux.Drivers[1]);
+  }
+  bool ok = (Mux.nDrivers > 0) ? Call(&Mux.Drivers[0]) : true;
+  if (Mux.nDrivers > 1) {
+	bool OtherOk = Other.get();
+	ok = ok && OtherOk;
+  }
+  return ok;
+}
+
+// Move worker of a back-end.  XyzMoveToPosition and XyzMoveToAngle only hand
+// the target over, so the two back-ends get their moves at the same time and
+// OMDAQ doesn't wait for either.  A newer target replaces one that wasn't
+// passed on yet.  A move the back-end refuses is reported as a hardware
+// fault of the axes of its role (see MuxStatus).
+void MuxWorker(MuxDriver *Driver) {
+  std::unique_lock<std::mutex> lock(Driver->Lock);
+  for (;;) {
+	Driver->Wake.wait(lock, [Driver] { return Driver->Quit ||
+		Driver->Pending[MuxLinear] || Driver->Pending[MuxRotary]; });
+	if (Driver->Quit) {
+	  break;
+	}
+	for (int r = 0; r < 2; ++r) {
+	  if (!Driver->Pending[r]) {
+		continue;
+	  }
+	  double Target[3];
+	  memcpy(Target, Driver->Target[r], sizeof(Target));
+	  Driver->Pending[r] = false;
+	  Driver->Running[r] = true;
+	  lock.unlock();
+	  bool ok = (r == MuxLinear) ? Driver->Routines.MoveToPosition(Target) :
+		  Driver->Routines.MoveToAngle(Target);
+	  lock.lock();
+	  Driver->Running[r] = false;
+	  if (!ok) {
+		Driver->Fault[r] = true;
+		snprintf(Driver->FaultText, sizeof(Driver->FaultText),
+			"The %s back-end refused the move",
+			(r == MuxLinear) ? "linear" : "rotary");
+	  }
+	  Driver->Wake.notify_all();
+	}
+  }
+}
+
+// Hands a move of Role over to the worker of its back-end.  A role without a
+// back-end does nothing.
+bool MuxMove(int Role, double *Target) {
+  MuxDriver *Driver = Mux.Role[Role];
+  if (Driver == NULL) {
+	return true;
+  }
+  std::lock_guard<std::mutex> lock(Driver->Lock);
+  if (!Driver->Worker.joinable()) {
+	return false;
+  }
+  memcpy(Driver->Target[Role], Target, sizeof(Driver->Target[Role]));
+  Driver->Pending[Role] = true;
+  Driver->Wake.notify_all();
+  return true;
+}
+
+// Drops the moves of Driver that weren't passed on and waits until the one
+// being passed on (if any) has been, so the next call to the back-end comes
+// after it.
+void MuxCancelMoves(MuxDriver *Driver) {
+  std::unique_lock<std::mutex> lock(Driver->Lock);
+  Driver->Pending[MuxLinear] = false;
+  Driver->Pending[MuxRotary] = false;
+  Driver->Wake.wait(lock, [Driver] {
+	  return !Driver->Running[MuxLinear] && !Driver->Running[MuxRotary]; });
+}
+
+// Path of the back-end DLL Name.  A name without a folder is looked for in
+// the folder of the multiplexer, which OMDAQ gives with XyzSetDLLfolder.
+std::string MuxDllPath(const char *Name) {
+  if (Mux.DllFolder.empty() || strpbrk(Name, "\\/:") != NULL) {
+	return Name;
+  }
+  char Folder[1024];
+  size_t n = wcstombs(Folder, Mux.DllFolder.c_str(), sizeof(Folder) - 1);
+  if (n == (size_t)-1) {
+	return Name;
+  }
+  Folder[n] = 0;
+  std::string Path = Folder;
+  if (Path[Path.size() - 1] != '\\' && Path[Path.size() - 1] != '/') {
+	Path += '\\';
+  }
+  return Path + Name;
+}
+
+// Initialises a loaded back-end with its options and starts its worker.
+bool MuxStartBackEnd(MuxDriver *Driver) {
+  MuxBackEnd &BackEnd = Driver->Routines;
+  if (BackEnd.SetParameterFileName != NULL && !Mux.ParameterFile.empty()) {
+	BackEnd.SetParameterFileName(&Mux.ParameterFile[0],
+		(int)Mux.ParameterFile.size() + 1);
+  }
+  if (BackEnd.SetDLLfolder != NULL && !Mux.DllFolder.empty()) {
+	BackEnd.SetDLLfolder(&Mux.DllFolder[0], (int)Mux.DllFolder.size() + 1);
+  }
+
+  std::vector<std::string> Given;
+  std::string Text = Mux.OptionText[Driver->Options];
+  size_t Start = 0;
+  while (!Text.empty() && Start <= Text.size()) {
+	size_t End = std::min(Text.find(';', Start), Text.size());
+	Given.push_back(Text.substr(Start, End - Start));
+	Start = End + 1;
+  }
+  int n = BackEnd.OptionCount();
+  std::vector<std::string> Options(n);
+  std::vector<char *> Pointers(n + 1);
+  for (int k = 0; k < n; ++k) {
+	if (k < (int)Given.size()) {
+	  Options[k] = Given[k];
+	}
+	else {
+	  char Value[MuxOptionLength] = {};
+	  BackEnd.OptionValue(k, Value, MuxOptionLength - 1);
+	  Options[k] = Value;
+	}
+	Pointers[k] = &Options[k][0];
+  }
+  if (!BackEnd.Initialise(&Pointers[0], n)) {
+	return false;
+  }
+
+  std::lock_guard<std::mutex> lock(Driver->Lock);
+  Driver->Quit = false;
+  for (int r = 0; r < 2; ++r) {
+	Driver->Pending[r] = false;
+	Driver->Fault[r] = false;
+  }
+  Driver->Worker = std::thread(MuxWorker, Driver);
+  return true;
+}
+
+// Stops the worker of a back-end and shuts the back-end down.
+bool MuxStopBackEnd(MuxDriver *Driver) {
+  std::unique_lock<std::mutex> lock(Driver->Lock);
+  if (!Driver->Worker.joinable()) {
+	return true;
+  }
+  Driver->Quit = true;
+  Driver->Pending[MuxLinear] = false;
+  Driver->Pending[MuxRotary] = false;
+  Driver->Wake.notify_all();
+  std::thread Worker = std::move(Driver->Worker);
+  lock.unlock();
+  Worker.join();
+  return Driver->Routines.ShutDown();
+}
+
+// Shuts down and unloads the back-ends of the previous XyzInitialise.
+void MuxRelease() {
+  MuxForEach(MuxStopBackEnd);
+  for (int d = 0; d < Mux.nDrivers; ++d) {
+	MuxFreeBackEnd(&Mux.Drivers[d].Routines);
+  }
+  Mux.nDrivers = 0;
+  Mux.Role[MuxLinear] = NULL;
+  Mux.Role[MuxRotary] = NULL;
+}
+
+// Merged status of axis iAxis (all axes if iAxis = -1) and the detail words
+// if AxisStatus is not NULL.  The bits of each axis come from the back-end
+// of its role, which is asked once.  While a move hasn't been passed on the
+// axes of its role are moving, and after a refused move they are in fault.
+// Both are taken before the back-ends are asked: a move the worker passes
+// on after that is then reported by the back-end, so a new move is never
+// seen in position before it has started.
+// A role without a back-end is in position, with the motors on if the
+// power is (OMDAQ-3 needs the linear axes), and missing in the detail words.
+DRVSTAT MuxStatus(int iAxis, DWORD *AxisStatus) {
+  DRVSTAT Status = 0;
+  MuxDriver *Asked = NULL;
+  DRVSTAT AskedBits = 0;
+  DWORD Detail[6];
+  bool Busy[2] = {};
+  bool Fault[2] = {};
+  for (int r = 0; r < 2; ++r) {
+	MuxDriver *Driver = Mux.Role[r];
+	if (Driver != NULL && (iAxis < 0 || iAxis / 3 == r)) {
+	  std::lock_guard<std::mutex> lock(Driver->Lock);
+	  Busy[r] = Driver->Pending[r] || Driver->Running[r];
+	  Fault[r] = Driver->Fault[r];
+	}
+  }
+  for (int r = 0; r < 2; ++r) {
+	if (iAxis >= 0 && iAxis / 3 != r) {
+	  continue;
+	}
+	MuxDriver *Driver = Mux.Role[r];
+	DRVSTAT Bits;
+	if (Driver == NULL) {
+	  Bits = MuxRoleBits(r, XyzStInPosition | Mux.PowerOn * XyzStMotorOn);
+	  for (int i = 0; i < 6; ++i) {
+		Detail[i] = AX_MISSING;
+	  }
+	}
+	else {
+	  if (Driver != Asked) {
+		AskedBits = Driver->Routines.AxisStatus(iAxis,
+			(AxisStatus != NULL) ? Detail : NULL);
+		Asked = Driver;
+	  }
+	  Bits = AskedBits;
+	  if (Busy[r]) {
+		Bits = (Bits & ~MuxRoleBits(r, XyzStInPosition)) |
+			MuxRoleBits(r, XyzStMoving);
+	  }
+	  Bits |= Fault[r] * MuxRoleBits(r, XyzStHwFault);
+	}
+	DRVSTAT Mask = MuxRoleBits(r, 0xFF);
+	if (iAxis >= 0) {
+	  Mask &= XyzAxisFlags(iAxis, 0xFF);
+	}
+	Status |= Bits & Mask;
+	if (AxisStatus != NULL) {
+	  if (iAxis >= 0) {
+		AxisStatus[0] = Detail[0];
+	  }
+	  else {
+		for (int i = 3 * r; i < 3 * r + 3; ++i) {
+		  AxisStatus[i] = Detail[i];
+		}
+	  }
+	}
+  }
+  return Status;
+}
+
+// Adminstration routines ++++++++++++++++++++++++++++++++++++++++++++++++++++
+//
+// XyzCapabilityMask returns the capabilities of the composite stage, see
+// MuxConfig.  OMDAQ asks for them before XyzInitialise, so they can't come
+// from the back-ends.
+XYZ_DLL DWORD _CALLSTYLE_ XyzCapabilityMask() {
+  return MuxConfig::CapabilityMask;
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzDllVersion(int * majorVersion, int * minorVersion,
+	int * buildNumber) {
+  *majorVersion = 1;
+  *minorVersion = 0;
+  *buildNumber = 1;
+  return true;
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzDescription(char *statusText, int nChar) {
+  strncpy(statusText, "Stage made of two stage DLLs (multiplexer)", nChar);
+  return true;
+}
+
+// XyzHwDescription gives the DLLs of the two roles.
+XYZ_DLL bool _CALLSTYLE_ XyzHwDescription(char *statusText, int nChar) {
+  std::string Text = std::string("Linear: ") +
+	  (Mux.OptionText[0][0] ? Mux.OptionText[0] : "none") + ", rotary: " +
+	  (Mux.OptionText[2][0] ? Mux.OptionText[2] : "none");
+  strncpy(statusText, Text.c_str(), nChar);
+  return true;
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzAuthor(char *statusText, int nChar) {
+  strncpy(statusText, "Multiplexer of OMDAQ-3 stage DLLs", nChar);
+  return true;
+}
+
+// ---------Procedures for optional parameters -----------------------------------
+XYZ_DLL int _CALLSTYLE_ XyzOptionCount() {
+  return nOptions;
+}
+
+// The parameter file name and the DLL folder are kept for the back-ends,
+// which get them in XyzInitialise.  The folder is also where the back-end
+// DLLs are looked for (see MuxDllPath).
+XYZ_DLL bool _CALLSTYLE_ XyzSetParameterFileName(wchar_t *cText, int nChar) {
+  Mux.ParameterFile.assign(cText, std::find(cText, cText + nChar, L'\0'));
+  return true;
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzSetDLLfolder(wchar_t *statusText, int nChar) {
+  Mux.DllFolder.assign(statusText,
+	  std::find(statusText, statusText + nChar, L'\0'));
+  return true;
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzOptionHeader(int nHdr, char * optionsHdr,
+	int szOptionsHdr) {
+  bool ok = false;
+  const char * initHdrs[nOptions] = {"Linear DLL", "Linear options",
+	  "Rotary DLL", "Rotary options"};
+  if ((nHdr >= 0) && (nHdr < nOptions)) {
+	strncpy(optionsHdr, initHdrs[nHdr], szOptionsHdr);
+	ok = true;
+  }
+  return ok;
+}
+
+// The default is no DLL for either role, to be set by the user.
+XYZ_DLL bool _CALLSTYLE_ XyzOptionValue(int nHdr, char * optionVal,
+	int szOptionVal) {
+  bool ok = false;
+  if ((nHdr >= 0) && (nHdr < nOptions)) {
+	strncpy(optionVal, Mux.OptionText[nHdr], szOptionVal);
+	ok = true;
+  }
+  return ok;
+}
+//
+// End of administration routines ++++++++++++++++++++++++++++++++++++++++++++
+
+// Initialisation routines +++++++++++++++++++++++++++++++++++++++++++++++++++
+//
+// XyzInitialise loads the back-end DLLs and initialises them at the same
+// time.  A role without a DLL is left out.  Returns false if a DLL can't be
+// loaded or initialised.
+XYZ_DLL bool _CALLSTYLE_ XyzInitialise(char **options, int szOptions) {
+  if (szOptions != nOptions) {
+	return false;
+  }
+  for (int i = 0; i < szOptions; ++i) {
+	memset(Mux.OptionText[i], 0, MuxOptionLength);
+	strncpy(Mux.OptionText[i], options[i], MuxOptionLength - 1);
+  }
+  Mux.optionsCopied = true;
+
+  MuxRelease();
+  for (int r = 0; r < 2; ++r) {
+	const char *Name = Mux.OptionText[2 * r];
+	if (Name[0] == 0) {
+	  continue;
+	}
+	if (r == MuxRotary && Mux.Role[MuxLinear] != NULL &&
+		strcmp(Name, Mux.OptionText[0]) == 0) {
+	  if (Mux.OptionText[3][0] != 0 &&
+		  strcmp(Mux.OptionText[3], Mux.OptionText[1]) != 0) {
+		MuxRelease();
+		return false;
+	  }
+	  Mux.Role[MuxRotary] = Mux.Role[MuxLinear];
+	  continue;
+	}
+	MuxDriver *Driver = &Mux.Drivers[Mux.nDrivers];
+	if (!MuxLoadBackEnd(&Driver->Routines, MuxDllPath(Name).c_str())) {
+	  MuxRelease();
+	  return false;
+	}
+	Driver->Options = 2 * r + 1;
+	++Mux.nDrivers;
+	Mux.Role[r] = Driver;
+  }
+
+  bool ok = MuxForEach(MuxStartBackEnd);
+  Mux.PowerOn = ok;
+  return ok;
+}
+
+// XyzShutDown stops the workers and shuts the back-ends down at the same
+// time.  The DLLs stay loaded until the next XyzInitialise, as OMDAQ may
+// still ask for the status.
+XYZ_DLL bool _CALLSTYLE_ XyzShutDown() {
+  return MuxForEach(MuxStopBackEnd);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzSetCurrentPosition(double * NewPosition) {
+  MuxDriver *Driver = Mux.Role[MuxLinear];
+  return (Driver == NULL) || Driver->Routines.SetCurrentPosition(NewPosition);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzSetCurrentAngle(double * NewAngle) {
+  MuxDriver *Driver = Mux.Role[MuxRotary];
+  return (Driver == NULL) || Driver->Routines.SetCurrentAngle(NewAngle);
+}
+//
+// End of initialisation ++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// Motion parameters +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//
+XYZ_DLL bool _CALLSTYLE_ XyzSetAccel(double * NewAccel) {
+  MuxDriver *Driver = Mux.Role[MuxLinear];
+  return (Driver == NULL) || Driver->Routines.SetAccel(NewAccel);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzSetSpeed(double * NewSpeed) {
+  MuxDriver *Driver = Mux.Role[MuxLinear];
+  return (Driver == NULL) || Driver->Routines.SetSpeed(NewSpeed);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzSetRotAccel(double * NewAccel) {
+  MuxDriver *Driver = Mux.Role[MuxRotary];
+  return (Driver == NULL) || Driver->Routines.SetRotAccel(NewAccel);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzSetRotSpeed(double * NewSpeed) {
+  MuxDriver *Driver = Mux.Role[MuxRotary];
+  return (Driver == NULL) || Driver->Routines.SetRotSpeed(NewSpeed);
+}
+
+// XyzPowerOn switches all the back-ends at the same time.
+XYZ_DLL bool _CALLSTYLE_ XyzPowerOn(bool Enabled) {
+  Mux.PowerOn = Enabled;
+  return MuxForEach([Enabled](MuxDriver *Driver) {
+	return Driver->Routines.PowerOn(Enabled); });
+}
+// End of motion parameters +++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// Motion commands. ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// The moves are handed over to the worker of the back-end (see MuxWorker) and
+// return at once.
+XYZ_DLL bool _CALLSTYLE_ XyzMoveToPosition(double * NewPosition) {
+  return MuxMove(MuxLinear, NewPosition);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzMoveToAngle(double * NewAngle) {
+  return MuxMove(MuxRotary, NewAngle);
+}
+
+// XyzHalt drops the moves not passed on yet and halts all the back-ends at
+// the same time.
+XYZ_DLL bool _CALLSTYLE_ XyzHalt() {
+  return MuxForEach([](MuxDriver *Driver) {
+	MuxCancelMoves(Driver);
+	return Driver->Routines.Halt(); });
+}
+//
+// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// Status reporting +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// The positions of a role without a back-end are 0.
+XYZ_DLL bool _CALLSTYLE_ XyzGetPosition(double * CurrentPosition) {
+  MuxDriver *Driver = Mux.Role[MuxLinear];
+  if (Driver == NULL) {
+	for (int i = 0; i < 3; ++i) {
+	  CurrentPosition[i] = 0;
+	}
+	return true;
+  }
+  return Driver->Routines.GetPosition(CurrentPosition);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzGetAngle(double * CurrentAngle) {
+  MuxDriver *Driver = Mux.Role[MuxRotary];
+  if (Driver == NULL) {
+	for (int i = 0; i < 3; ++i) {
+	  CurrentAngle[i] = 0;
+	}
+	return true;
+  }
+  return Driver->Routines.GetAngle(CurrentAngle);
+}
+
+// GetMotorTemp takes the temperature of each axis from the back-end of its
+// role, 0 if the back-end has no temperatures.
+XYZ_DLL bool _CALLSTYLE_ XyzGetMotorTemp(double *MotorTemp, int iAxis) {
+  if (iAxis >= 6) {
+	return false;
+  }
+  bool ok = true;
+  for (int r = 0; r < 2; ++r) {
+	if (iAxis >= 0 && iAxis / 3 != r) {
+	  continue;
+	}
+	MuxDriver *Driver = Mux.Role[r];
+	double Temp[6] = {0, 0, 0, 0, 0, 0};
+	if (Driver != NULL && Driver->Routines.GetMotorTemp != NULL) {
+	  ok = Driver->Routines.GetMotorTemp(Temp, iAxis) && ok;
+	}
+	if (iAxis >= 0) {
+	  MotorTemp[0] = Temp[0];
+	}
+	else {
+	  for (int i = 3 * r; i < 3 * r + 3; ++i) {
+		MotorTemp[i] = Temp[i];
+	  }
+	}
+  }
+  return ok;
+}
+// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// Status and Error handling commands.  *************************************
+//
+// See MuxStatus.
+XYZ_DLL DRVSTAT _CALLSTYLE_ XyzStageStatus(DWORD * AxisStatus) {
+  return MuxStatus(-1, AxisStatus);
+}
+
+XYZ_DLL DRVSTAT _CALLSTYLE_ XyzAxisStatus(int iAxis, DWORD * AxisStatus) {
+  if (iAxis >= 6) {
+	return 0;
+  }
+  return MuxStatus(iAxis, AxisStatus);
+}
+
+// XyzFaultAck clears the refused moves and acknowledges the faults of all the
+// back-ends at the same time.  The result is the worst of their results.
+XYZ_DLL int _CALLSTYLE_ XyzFaultAck() {
+  int Result[2] = {XyzFltAckOK, XyzFltAckOK};
+  MuxForEach([&Result](MuxDriver *Driver) {
+	{
+	  std::lock_guard<std::mutex> lock(Driver->Lock);
+	  Driver->Fault[MuxLinear] = false;
+	  Driver->Fault[MuxRotary] = false;
+	}
+	Result[Driver - Mux.Drivers] = Driver->Routines.FaultAck();
+	return true; });
+  if (Result[0] == XyzFltAckFatal || Result[1] == XyzFltAckFatal) {
+	return XyzFltAckFatal;
+  }
+  if (Result[0] == XyzFltAckRetry || Result[1] == XyzFltAckRetry) {
+	return XyzFltAckRetry;
+  }
+  return XyzFltAckOK;
+}
+
+// XyzLastFaultText returns the text of a refused move, or else the text of
+// the first back-end with a fault on its axes.
+XYZ_DLL bool _CALLSTYLE_ XyzLastFaultText(char *statusText, int nChar) {
+  DRVSTAT Faults = ST_ALL_XYZ_HWFAULT | ST_ALL_R3_HWFAULT | ST_ALL_XYZ_LIMIT |
+	  ST_ALL_R3_LIMIT;
+  for (int r = 0; r < 2; ++r) {
+	MuxDriver *Driver = Mux.Role[r];
+	if (Driver == NULL) {
+	  continue;
+	}
+	{
+	  std::lock_guard<std::mutex> lock(Driver->Lock);
+	  if (Driver->Fault[r]) {
+		strncpy(statusText, Driver->FaultText, nChar);
+		return true;
+	  }
+	}
+	if (Driver->Routines.AxisStatus(-1, NULL) & MuxRoleBits(r, 0xFF) &
+		Faults) {
+	  return Driver->Routines.LastFaultText(statusText, nChar);
+	}
+  }
+  strncpy(statusText, "No fault", nChar);
+  return true;
+}
+//
+// *************************************************************************
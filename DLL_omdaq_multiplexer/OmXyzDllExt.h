@@ -0,0 +1,16 @@
+///--------------------------------------------------------------------------
+// OMXYZDLLEXT.H
+// Status layout shared by the stage DLLs (see XyzStatusLayout.h), used by
+// the multiplexer OMXYZDLL.DLL to merge the status of its back-ends.
+//
+// The multiplexer only exports the OMDAQ-3 calls of OmXyzDll.h (which must not
+// be changed).
+// OmXyzDll.h must be included before this file.
+// ---------------------------------------------------------------------------
+
+#ifndef OmXyzDllExtH
+#define OmXyzDllExtH
+
+#include "../DLL_omdaq_common/XyzStatusLayout.h"
+
+#endif
@@ -28,64 +28,604 @@ to C.
 #include <stdlib>
 #define XYZDLL_EXPORTS 1
 #include "OmXyzDll.h"
-#include "rs232.h"
+#include "SerialTransport.h"
 #include <cstring>
 #include <string>
 #include <sstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <vector>
+#include <chrono>
+#include <new>
 #include <windows.h>
 
 #define XYZDLL_EXPORTS 1
 #include "OmXyzDll.h"
+#include "OmXyzDllExt.h"
+#include "V8849Orders.h"
+#include "../DLL_omdaq_common/SeqLock.h"
+#include "../DLL_omdaq_common/XyzStageConfig.h"
 // ---------------------------------------------------------------------------
 #pragma package(smart_init)
 
 using namespace std;
 
-// ______Global variables____________________________
-
-
-double CurrentDllPosition[3];
-double CurrentDllAngle[3];
-double DemandPosition[3];
-double DemandAngle[3];
-double PosStep[3];
-double AngleStep[3];
-double LinSpeed[3];
-double RotSpeed[3];
-clock_t tLin;
-clock_t tRot;
-bool DllPowerOn;
-#define nOptions 8
-char OptionText[nOptions][32];
-bool optionsCopied = false;
-
-
-/*Global variables are useful since they can be accessed and modified by
-any function. Besides the global variables included originally in the code
-provided with OMDAQ-3, the following global variables were added. */
- /*Global variables to store RS232 communication parameters,
-initialized with 0's. Two sets of variables are declared. One set to open the
-regular communication port to communicate with the V8849 motor control board
-and one set to open a second port that controls the power of the motor, to
-prevent electromagnetic noise. The variables for the noise COM port
-end with "N". */
-char modo[4]="0", modoN[4]="0";
-int taxabaud=0, taxabaudN=0;
-int port_nmr=0, port_nmrN=0;
-
-/*Global variable to store the number of steps/rotation of the motor, obtained
-from the OMDAQ-3 parameters window. Although it is not likely the user may wish
-to change the microstepping mode of the motor.   */
-double steps_rev;
+// ______Stage state____________________________
+
+
+#define nOptions 10
+
+
+/*Axes of the stage, see XyzStageConfig.h. OMDAQ-3 is told that the stage has
+the 3 linear axes and 1 rotation axis (see XyzCapabilityMask()), but only the
+rotation axis (axis 3) is driven by the V8849 board. */
+typedef XyzStageConfig<3, 1, 0, 1u << 3> StageConfig;
+
+
+/*State of the stage that is reported to OMDAQ-3 by the status routines
+(XyzGetAngle(...), XyzAxisStatus(...), ...). It is published through a
+sequence lock (see SeqLock.h) each time it changes, so that the status
+routines never wait for the motion worker and never see a state that is half
+way through being updated. CurrentAngle is the angle the motor is (or will
+be) at, i.e. the demanded angle rounded to whole motor steps. */
+struct StageSnapshot {
+  double DemandAngle[3];
+  double CurrentAngle[3];
+  double AngleStep[3];
+  bool MotionBusy;
+  bool MotorRotating;
+  bool MotionFault;
+  bool DllPowerOn;
+};
+
+
+/*All the variables of the DLL are kept in a stage context, struct XyzStage,
+so that one program can drive several stages, each one with its own board,
+COM ports and motion worker (see XyzCreateStage()). The OMDAQ-3 routines
+work on DefaultStage. Besides the variables included originally in the code
+provided with OMDAQ-3, the following variables were added. */
+struct XyzStage {
+
+  double CurrentDllPosition[3] = {};
+  double CurrentDllAngle[3] = {};
+  double DemandPosition[3] = {};
+  double DemandAngle[3] = {};
+  double PosStep[3] = {};
+  double AngleStep[3] = {};
+  double LinSpeed[3] = {};
+  double RotSpeed[3] = {};
+  clock_t tLin = 0;
+  clock_t tRot = 0;
+  bool DllPowerOn = false;
+  char OptionText[nOptions][32] = {};
+  bool optionsCopied = false;
+
+
+  /*Variables to store RS232 communication parameters. Two sets of variables
+  are declared. One set to open the regular communication port to communicate
+  with the V8849 motor control board and one set to open a second port that
+  controls the power of the motor, to prevent electromagnetic noise. The
+  variables for the noise COM port end with "N".
+  The ports are opened with OpenSerialTransport(...), see SerialTransport.h,
+  so the port option is the COM number on Windows and the device on Linux.
+  PortMutex is locked around every use of port (an order, or a query and its
+  answer), so that the orders of different threads are not mixed and each
+  answer is read by the thread that asked for it. MotionMutex may be locked
+  while PortMutex is held, but not the other way round. */
+  char modo[4] = "0", modoN[4] = "0";
+  int taxabaud = 0, taxabaudN = 0;
+  SerialTransport *port = NULL, *portN = NULL;
+  std::mutex PortMutex;
+
+  /*Number of steps/rotation of the motor, obtained from the OMDAQ-3
+  parameters window. Although it is not likely the user may wish to change the
+  microstepping mode of the motor.   */
+  double steps_rev = 0;
+
+  /*Actual speed of the motor in steps per second, i.e. the argument of
+  cvel(u) divided by the prescale factor. Set up in XyzInitialise(...) and
+  used to estimate how long a move takes. */
+  double step_rate = 0;
+
+  /*Arguments of the prescale(p) and cvel(u) orders sent to the board in
+  XyzInitialise(...), so that they can be sent again after a "new" order. */
+  long board_prescale = 1;
+  long board_cvel = 0;
+
+
+  /*Variables used by the motion worker. XyzMoveToAngle(...) only hands the
+  move over to this background thread, which turns the motor on, sends the
+  move order, waits for the motion to finish and turns the motor back off. In
+  this way OMDAQ-3 is not blocked while the motor is rotating.
+  MotionBusy is true from the moment a move is requested until the worker has
+  turned the motor off again, and is used by XyzAxisStatus(...) to report
+  ST_RO1_MOVING. MotorRotating is only true from the moment the move order is
+  sent until the board reports the motor at the target. MotionFault is set
+  when the board doesn't confirm the target in time, and is only cleared by
+  XyzFaultAck() (or XyzInitialise(...)). StatusChanged is
+  signalled every time the state is published, see XyzWaitStatusChange(...).
+  MotionCallback is called by the worker when the board confirms the target,
+  see XyzSetMotionCallback(...). MotionCallbackActive is true during the
+  call. BoardSteps is the last position of the motor known from the board,
+  i.e. the last answer to a position query, the last confirmed target or the
+  datum set by XyzSetCurrentAngle(...). The worker estimates the duration of
+  each move from it, since moves merged by the worker don't start at the
+  angle requested before.
+  All these variables are protected by MotionMutex. */
+  std::thread MotionThread;
+  std::mutex MotionMutex;
+  std::condition_variable MotionWake;
+  std::condition_variable StatusChanged;
+  bool MotionRequested = false;
+  bool MotionQuit = false;
+  long MotionTargetSteps = 0;
+  bool MotionFromSequence = false;
+  long BoardSteps = 0;
+  bool MotionBusy = false;
+  bool MotorRotating = false;
+  bool MotionFault = false;
+  XyzMotionCallback MotionCallback = NULL;
+  void *MotionCallbackUser = NULL;
+  bool MotionCallbackActive = false;
+
+
+  /*Variables of the power gating. After a move the worker keeps the motor
+  powered for PowerHoldTime milliseconds. If a new move arrives within this
+  time the motor is not turned off and on again, which saves PowerSettleTime
+  milliseconds, the time the motor needs to settle after being powered.
+  PowerGateRequested is set by XyzAcquisitionStarting() to turn the motor off
+  immediately, or as soon as the move in progress ends, without hold time. It
+  stays set until the worker has turned the motor off. MotorEnergized is true
+  while the motor is powered; it is changed by the worker (see MotorPower(...))
+  and read by XyzAcquisitionStarting(). The counters are returned by
+  XyzPowerGatingCounters(...). All are protected by MotionMutex. */
+  long PowerHoldTime = 0;
+  long PowerSettleTime = 0;
+  bool PowerGateRequested = false;
+  bool MotorEnergized = false;
+  int PowerUps = 0;
+  int PowerTogglesAvoided = 0;
+  double PowerTimeSaved = 0;
+
+
+  /*Angle sequence loaded in the board by XyzLoadAngleSequence(...).
+  SequenceSteps holds the positions of the sequence in motor steps and
+  SequenceNext is the index of the next position, as requested by
+  XyzMoveToAngle(...). SequenceBoardNext is the value of iseq in the board,
+  i.e. the position the board moves to when it receives the trigger order.
+  They differ when the worker merged several moves into one (see
+  MotionWorker()).
+  Protected by MotionMutex. */
+  std::vector<long> SequenceSteps;
+  size_t SequenceNext = 0;
+  size_t SequenceBoardNext = 0;
+
+
+  /*Statistics of the round trip time of the position queries, i.e. the time
+  between sending the query and receiving the answer, in milliseconds. They
+  measure the actual latency of one order over the serial link and are
+  returned by XyzSerialLatency(...). Protected by MotionMutex. */
+  int QueryCount = 0;
+  double QueryTimeTotal = 0;
+  double QueryTimeMax = 0;
+
+
+  /*State read by the status routines. It is written by PublishState(...)
+  with MotionMutex locked, and read without any lock. */
+  SeqLock<StageSnapshot> Published;
+};
+
+XyzStage DefaultStage;
+
+
+/*Converts an angle in degrees to the nearest whole number of motor steps,
+which is the position that the board is ordered to move to. */
+long AngleToSteps(XyzStage *Stage, double angle) {
+  return lround(angle*Stage->steps_rev/360);
+}
+
+
+/*Copies the reported state of the stage into Stage->Published and wakes up the
+XyzWaitStatusChange(...) calls. Must be called with MotionMutex locked every
+time one of the variables of StageSnapshot changes. */
+void PublishState(XyzStage *Stage) {
+  StageSnapshot state;
+  for (int i = 0; i < 3; ++i) {
+	state.DemandAngle[i] = Stage->DemandAngle[i];
+	state.CurrentAngle[i] = Stage->CurrentDllAngle[i];
+	state.AngleStep[i] = Stage->AngleStep[i];
+  }
+  state.MotionBusy = Stage->MotionBusy;
+  state.MotorRotating = Stage->MotorRotating;
+  state.MotionFault = Stage->MotionFault;
+  state.DllPowerOn = Stage->DllPowerOn;
+  Stage->Published.Write(state);
+  Stage->StatusChanged.notify_all();
+}
+
+
+/*Builds the status mask of axis iAxis (all axes if iAxis = -1) and the
+detail words in AxisStatus (if not NULL) from the published state. See
+XyzAxisStatus(...). */
+DRVSTAT ReportedStatus(const StageSnapshot &state, int iAxis,
+	DWORD *AxisStatus) {
+  DRVSTAT status = 0;
+
+  /*The rotation axis is moving while the motion worker is executing a move,
+  i.e. until the motor has been turned off again. The axes that are not
+  driven (see StageConfig) are always in position, and the 2nd and 3rd
+  rotation axes report nothing. Only the driven axis is present in the detail
+  words, where it is at constant speed while the motor is rotating (the board
+  has no ramps). After a move that the board didn't confirm the rotation axis
+  is in fault, and not in position, until XyzFaultAck(). */
+  DRVSTAT moving = state.MotionBusy |
+	  (fabs(state.CurrentAngle[0] - state.DemandAngle[0]) > state.AngleStep[0]);
+  DRVSTAT power_on = state.DllPowerOn;
+  DRVSTAT rotating = state.MotorRotating;
+  DRVSTAT fault = state.MotionFault;
+
+  /*The flags of each axis are built without any branches from the tests
+  above (0 or 1) and shifted into the bits of the axis (see XyzStatusShift in
+  OmXyzDllExt.h). The motors of the reported axes are on if the DLL is. The
+  loop is unrolled by StageConfig::ForEachAxis(...), so the tests on the
+  configuration of each axis are constants. */
+  StageConfig::ForEachAxis([&](auto axis) {
+	constexpr int i = decltype(axis)::value;
+	if(iAxis >= 0 && iAxis != i) {
+	  return;
+	}
+	DRVSTAT reported = StageConfig::Reported(i);
+	DRVSTAT driven = StageConfig::IsDriven(i);
+	DRVSTAT axis_moving = driven * moving;
+	DRVSTAT axis_fault = driven * fault;
+	DRVSTAT flags = axis_moving * XyzStMoving |
+		(1 - axis_moving) * (1 - axis_fault) * XyzStInPosition |
+		axis_fault * XyzStHwFault | power_on * XyzStMotorOn;
+	status |= reported * XyzAxisFlags(i, flags);
+	if(AxisStatus != NULL) {
+	  AxisStatus[(iAxis >= 0) ? 0 : i] = (DWORD)((1 - driven) * AX_MISSING |
+		  driven * (AX_ACTIVE | power_on * AX_MOTOR_ON |
+		  axis_moving * AX_MOVING | rotating * AX_CONST_SPEED));
+	}
+  });
+
+  return status;
+}
 
 
 /*Global variable used to prevent RS-232 communications just to test the DLL
 without the hardware. If false no RS232 orders are sent and there's no error
 when linking OMDAQ-3 with the DLL without the actual RS232 connection
-established */
+established. It applies to all the stages. */
 bool COMS=true;
 
 
+/*Parameters of the completion detection. Instead of waiting a fixed time the
+motion worker asks the board for the position of the motor and turns the motor
+off as soon as the target is reached. The interval between position queries
+adapts to the distance still to travel, within PollMinTime and PollMaxTime
+(milliseconds). If the board doesn't confirm the target within the expected
+travel time plus MotionTimeoutPad the motor is turned off anyway and the move
+is reported as a fault (see MotionWorker()).
+ReplyTimeout is the time to wait for the board to answer a query. */
+#define PollMinTime 10
+#define PollMaxTime 250
+#define MotionTimeoutPad 2000
+#define ReplyTimeout 100
+
+
+/*Pauses the motion worker for ms milliseconds. Returns false if the DLL is
+being shut down, in which case the worker must stop waiting. */
+bool MotionPause(XyzStage *Stage, long ms) {
+  std::unique_lock<std::mutex> lock(Stage->MotionMutex);
+  return !Stage->MotionWake.wait_for(lock, std::chrono::milliseconds(ms),
+	  [Stage] { return Stage->MotionQuit; });
+}
+
+
+/*Asks the V8849 control board for the position of motor 0, in motor steps,
+with the "print(pos(0))" order. The answer is read from the same COM port used
+to send the orders. Any characters left in the input buffer are discarded
+before asking, and lines of the answer that are not a number (e.g. the echo
+of the order) are skipped. Returns false if no position is received within
+ReplyTimeout milliseconds. */
+bool QueryBoardPosition(XyzStage *Stage, long *steps) {
+
+  char buffer[32];
+  char line[32];
+  int n=0;
+
+  std::lock_guard<std::mutex> port_lock(Stage->PortMutex);
+  Stage->port->Discard();
+
+  auto t_start = std::chrono::steady_clock::now();
+  auto t_end = t_start + std::chrono::milliseconds(ReplyTimeout);
+
+  V8849Order order;
+  Stage->port->Puts(V8849PrintPos(&order, 0));
+
+  while(true) {
+
+	auto t_now = std::chrono::steady_clock::now();
+	if(t_now >= t_end) {
+	  return false;
+	}
+	long timeout = (long)std::chrono::duration_cast<std::chrono::milliseconds>(
+		t_end - t_now).count();
+
+	int nRead = Stage->port->Read(buffer, sizeof(buffer), timeout);
+	if(nRead < 0) {
+	  return false;
+	}
+
+	for (int i = 0; i < nRead; ++i) {
+
+	  char c = buffer[i];
+	  if(c != '\n' && c != '\r') {
+		if(n < (int)sizeof(line)-1) {
+		  line[n++] = c;
+		}
+		continue;
+	  }
+
+	  line[n] = 0;
+	  char *end;
+	  long value = strtol(line, &end, 10);
+	  if(n > 0 && *end == 0) {
+		*steps = value;
+
+		double t_query = std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now() - t_start).count();
+		std::lock_guard<std::mutex> lock(Stage->MotionMutex);
+		Stage->BoardSteps = value;
+		++Stage->QueryCount;
+		Stage->QueryTimeTotal += t_query;
+		if(t_query > Stage->QueryTimeMax) {
+		  Stage->QueryTimeMax = t_query;
+		}
+		return true;
+	  }
+	  n = 0;
+	}
+  }
+}
+
+
+/*Waits until motor 0 reaches target_steps. travel_time is the expected
+duration of the move in milliseconds. The worker sleeps for half of the time
+that is expected to still be needed to reach the target (calculated from the
+last position read from the board), within PollMinTime and PollMaxTime, and
+asks the board again. In this way few queries are sent during a long move and
+the end of the move is detected within PollMinTime.
+Without RS232 communications (COMS=false) the worker just waits for the
+travel time. Returns false if the target was not confirmed in time. */
+bool WaitForTargetSteps(XyzStage *Stage, long target_steps, float travel_time) {
+
+  if(!COMS) {
+	return MotionPause(Stage, (long)travel_time);
+  }
+
+  auto t_end = std::chrono::steady_clock::now() +
+	  std::chrono::milliseconds((long)travel_time + MotionTimeoutPad);
+
+  long remaining_time = (long)travel_time;
+
+  while(std::chrono::steady_clock::now() < t_end) {
+
+	long interval = remaining_time/2;
+	if(interval < PollMinTime) {
+	  interval = PollMinTime;
+	}
+	if(interval > PollMaxTime) {
+	  interval = PollMaxTime;
+	}
+	if(!MotionPause(Stage, interval)) {
+	  return false;
+	}
+
+	long steps;
+	if(QueryBoardPosition(Stage, &steps)) {
+	  if(steps == target_steps) {
+		return true;
+	  }
+	  if(Stage->step_rate > 0) {
+		remaining_time = (long)(labs(target_steps-steps)/Stage->step_rate*1000);
+	  }
+	}
+  }
+
+  return false;
+}
+
+
+/*Turns the power of the motor on or off. The voltage level of the DTR pin of
+the noise RS232 port controls the power of the motor. Must be called with
+MotionMutex locked, since XyzAcquisitionStarting() reads MotorEnergized. */
+void MotorPower(XyzStage *Stage, bool on) {
+  if(COMS) {
+	Stage->portN->SetDTR(on);
+  }
+  Stage->MotorEnergized = on;
+}
+
+
+/*Motion worker. Waits for a move requested by XyzMoveToAngle(...) and
+performs it: turns the motor on, sends the Cmove(val,0) order, waits until the
+board reports that the motor reached the target (see WaitForTargetSteps(...))
+and turns the motor back off again. The wait is interrupted if the DLL is shut
+down.
+The motor is only turned off after PowerHoldTime milliseconds without new
+moves, or earlier if XyzAcquisitionStarting() is called. */
+void MotionWorker(XyzStage *Stage) {
+
+  V8849Order order;
+  std::unique_lock<std::mutex> lock(Stage->MotionMutex);
+
+  while(!Stage->MotionQuit) {
+
+	Stage->MotionWake.wait(lock,
+		[Stage] { return Stage->MotionRequested || Stage->MotionQuit; });
+	if(Stage->MotionQuit) {
+	  break;
+	}
+
+	Stage->MotionRequested = false;
+	long target_steps = Stage->MotionTargetSteps;
+
+	/*Moves requested while the previous one was in progress are merged into
+	the last one, so the board may be more than one position behind the
+	sequence of the host. The trigger order is only used if the board is at
+	the position just before the target. Otherwise the target is sent as a
+	Cmove order and iseq is set in the board to the index of the host. */
+	bool from_sequence = Stage->MotionFromSequence &&
+		Stage->SequenceBoardNext + 1 == Stage->SequenceNext;
+	bool sequence_resync = !from_sequence &&
+		Stage->SequenceBoardNext != Stage->SequenceNext;
+	long sequence_next = (long)Stage->SequenceNext;
+	Stage->SequenceBoardNext = Stage->SequenceNext;
+
+	/*Expected travel time of the motor, from the last position known from
+	the board to the target. */
+	float time_sleep = 0;
+	if(Stage->step_rate > 0) {
+	  time_sleep = labs(target_steps-Stage->BoardSteps)/Stage->step_rate*1000;
+	}
+	bool energized = Stage->MotorEnergized;
+	long settle_time = Stage->PowerSettleTime;
+	if(energized) {
+	  ++Stage->PowerTogglesAvoided;
+	  Stage->PowerTimeSaved += settle_time;
+	}
+	else {
+	  ++Stage->PowerUps;
+	  //Turning motor on, unless it is still on from the previous move
+	  MotorPower(Stage, true);
+	}
+	lock.unlock();
+
+	/*Setting up move order. Cmove(val, axis) only accepts an integer
+	number of steps. If the target is the next position of the angle sequence
+	loaded in the board only the short trigger order is needed. */
+	const char *move_order;
+	if(from_sequence) {
+	  move_order = V8849SeqTrigger(&order);
+	}
+	else {
+	  move_order = V8849Cmove(&order, target_steps, 0);
+	}
+
+	/*Letting the motor settle if it was turned on above, i.e. if it was not
+	still on from the previous move. */
+	if(!energized) {
+	  MotionPause(Stage, settle_time);
+	}
+
+	//Sending the move order
+	lock.lock();
+	Stage->MotorRotating = true;
+	PublishState(Stage);
+	lock.unlock();
+	if(COMS){
+	std::lock_guard<std::mutex> port_lock(Stage->PortMutex);
+	Stage->port->Puts(move_order);
+	if(sequence_resync) {
+	  Stage->port->Puts(V8849SeqIndexSet(&order, sequence_next));
+	}
+	}
+
+	/*Waiting for the motion to be completed so that the motor is correctly
+	turned off only AFTER the motion is completed. */
+	bool confirmed = WaitForTargetSteps(Stage, target_steps, time_sleep);
+
+	lock.lock();
+	Stage->tRot = clock();
+	Stage->MotorRotating = false;
+	if(confirmed) {
+	  Stage->BoardSteps = target_steps;
+	}
+
+	/*The move is completed: the motor is reported in position, unless another
+	move was requested in the meantime. If the board didn't confirm the target
+	step (the motor stalled or the board stopped answering) the axis is
+	reported in fault instead, until XyzFaultAck(). */
+	if(!Stage->MotionRequested) {
+	  Stage->MotionBusy = false;
+	}
+	if(!confirmed && !Stage->MotionQuit) {
+	  Stage->MotionFault = true;
+	}
+	PublishState(Stage);
+
+	/*Telling the host that the motor is in position, if the board confirmed
+	the target step, or that the axis is in fault. The callback is called
+	without MotionMutex, so that it can call the other routines of the DLL. */
+	DRVSTAT events = confirmed ? ST_RO1_INPOSITION : ST_RO1_HWFAULT;
+	if((confirmed || Stage->MotionFault) && !Stage->MotionBusy &&
+		!Stage->MotionQuit && Stage->MotionCallback != NULL) {
+	  XyzMotionCallback callback = Stage->MotionCallback;
+	  void *user = Stage->MotionCallbackUser;
+	  Stage->MotionCallbackActive = true;
+	  lock.unlock();
+	  XyzSnapshot snapshot;
+	  XyzCtxGetSnapshot(Stage, &snapshot);
+	  callback(user, events, &snapshot);
+	  lock.lock();
+	  Stage->MotionCallbackActive = false;
+	  Stage->MotionWake.notify_all();
+	}
+
+	/*Holding the motor powered in case the next move arrives soon, unless
+	XyzAcquisitionStarting() asked for it to be turned off. */
+	Stage->MotionWake.wait_for(lock,
+		std::chrono::milliseconds(Stage->PowerHoldTime), [Stage] {
+		return Stage->MotionRequested || Stage->MotionQuit ||
+			Stage->PowerGateRequested; });
+
+	/*Turning the motor back off again if no move is waiting. This also
+	completes the request of XyzAcquisitionStarting(), if any. */
+	if(!Stage->MotionRequested) {
+	  MotorPower(Stage, false);
+	  Stage->PowerGateRequested = false;
+	  Stage->MotionWake.notify_all();
+	}
+  }
+
+  if(Stage->MotorEnergized) {
+	MotorPower(Stage, false);
+  }
+  Stage->PowerGateRequested = false;
+}
+
+
+/*True if the caller is the motion worker of the stage, i.e. the call comes
+from the motion callback (see XyzSetMotionCallback(...)). The worker can't
+wait for itself, so the routines that stop it refuse these calls. */
+bool OnMotionThread(XyzStage *Stage) {
+  return Stage->MotionThread.get_id() == std::this_thread::get_id();
+}
+
+
+/*Stops the motion worker and waits until it has finished. A move in progress
+is abandoned and the motor is turned off (see MotionWorker()). Must be called
+before the ports are closed or replaced, since the worker uses them. */
+void StopMotionWorker(XyzStage *Stage) {
+
+  if(Stage->MotionThread.joinable()) {
+	{
+	  std::lock_guard<std::mutex> lock(Stage->MotionMutex);
+	  Stage->MotionQuit = true;
+	}
+	Stage->MotionWake.notify_all();
+	Stage->MotionThread.join();
+  }
+
+  std::lock_guard<std::mutex> lock(Stage->MotionMutex);
+  Stage->MotionRequested = false;
+  Stage->MotionBusy = false;
+}
+
 
 /******************************* Adminstration routines *******************************/
 
@@ -98,7 +638,7 @@ bool COMS=true;
  defined in OmXyzDll_StatusBits.h */
  /*>>>>>> THIS MUST BE DEFINED <<<<<<<*/
 XYZ_DLL DWORD _CALLSTYLE_ XyzCapabilityMask() {
-  return (XYZCAP_XYZ3 | XYZCAP_ROT1);
+  return StageConfig::CapabilityMask;
 
 
   /*This declares that the stage is capable of translation along the 3
@@ -210,13 +750,16 @@ steps that the motor performs to complete a full rotation. Unlike the speed of
 the motor this parameter only informs OMDAQ of the hardware settings and is not
 configurable at run time. The motor used performs 200 steps/revolution in
 normal stepping mode and is usualy configured for quarter step mode where it
-performs 800 steps/revolution.*/
+performs 800 steps/revolution.
+The hold time and settle time parameters (in milliseconds) configure the power
+gating of the motor, see XyzSetPowerGating(...). With a hold time of 0 the
+motor is turned off as soon as each move is completed.*/
 XYZ_DLL bool _CALLSTYLE_ XyzOptionHeader(int nHdr, char * optionsHdr,
 	int szOptionsHdr) {
   bool ok = false;
 
 
-  char * initHdrs[nOptions] = {"COM", "Baud", "Mode", "COM (noise)", "Baud (noise)", "Mode (noise)", "Speed (/s)", "Steps/rotation"}; // For example...
+  char * initHdrs[nOptions] = {"COM", "Baud", "Mode", "COM (noise)", "Baud (noise)", "Mode (noise)", "Speed (/s)", "Steps/rotation", "Hold time (ms)", "Settle time (ms)"}; // For example...
   if ((nHdr >= 0) && (nHdr < nOptions)) {
 	strncpy(optionsHdr, initHdrs[nHdr], szOptionsHdr);
 	ok = true;
@@ -231,17 +774,17 @@ nHdr is out of range. */
 (the one with the NVIDIA board). 2) If the speed of the motor is too high the
 hardware cannot keep up.
 */
-XYZ_DLL bool _CALLSTYLE_ XyzOptionValue(int nHdr, char * optionVal,
-	int szOptionVal) {
+XYZ_DLL bool _CALLSTYLE_ XyzCtxOptionValue(XYZSTAGE Stage, int nHdr,
+	char * optionVal, int szOptionVal) {
   bool ok = false;
 
 
-  char * initVals[nOptions] = {"5", "9600", "8N1", "0", "9600", "8N1", "30", "800"};
+  char * initVals[nOptions] = {"5", "9600", "8N1", "0", "9600", "8N1", "30", "800", "0", "0"};
   if ((nHdr >= 0) && (nHdr < nOptions)) {
-	if (!optionsCopied) {
-	  strncpy(&OptionText[nHdr][0], initVals[nHdr], 32*sizeof(char));
+	if (!Stage->optionsCopied) {
+	  strncpy(&Stage->OptionText[nHdr][0], initVals[nHdr], 32*sizeof(char));
 	}
-	strncpy(optionVal, &OptionText[nHdr][0], szOptionVal);
+	strncpy(optionVal, &Stage->OptionText[nHdr][0], szOptionVal);
 	ok = true;
   }
   return ok;
@@ -255,7 +798,8 @@ XYZ_DLL bool _CALLSTYLE_ XyzOptionValue(int nHdr, char * optionVal,
 /****************************** Initialisation routines *******************************/
 
 // ---------------------------------------------------------------------------
-XYZ_DLL bool _CALLSTYLE_ XyzInitialise(char **options, int szOptions) {
+XYZ_DLL bool _CALLSTYLE_ XyzCtxInitialise(XYZSTAGE Stage, char **options,
+	int szOptions) {
 
 
 	/* Initialisation code here
@@ -263,8 +807,8 @@ XYZ_DLL bool _CALLSTYLE_ XyzInitialise(char **options, int szOptions) {
    This function obtains the parameter values from the parameters window
    interface through the char **options argument. Namely the RS232
    communication parameters, the speed and the number of steps for a full
-   roation of the motor. Global variables store these parameters so that they
-   can be used by every function in the DLL.
+   roation of the motor. The stage context stores these parameters so that
+   they can be used by every function in the DLL.
 
    Two RS232 channels are opened - one to send the motor commands to the
    V8849 motor control board and the other to cut the current supply of the
@@ -278,39 +822,51 @@ XYZ_DLL bool _CALLSTYLE_ XyzInitialise(char **options, int szOptions) {
 	*/
 
 
-  if (szOptions != nOptions) {
+  if (szOptions != nOptions || OnMotionThread(Stage)) {
 	return false;
   }
 
   for (int i = 0; i < szOptions; ++i) {
-	ZeroMemory(&OptionText[i][0], 32*nOptions*sizeof(char));
-	strcpy(&OptionText[i][0], options[i]);
+	ZeroMemory(&Stage->OptionText[i][0], 32*sizeof(char));
+	strncpy(&Stage->OptionText[i][0], options[i], 31);
   }
-  optionsCopied = true;
+  Stage->optionsCopied = true;
 
   for (int i = 0; i < 3; ++i) {
-	CurrentDllPosition[i] = 0;
-	CurrentDllAngle[i] = 0;
+	Stage->CurrentDllPosition[i] = 0;
+	Stage->CurrentDllAngle[i] = 0;
   }
 
+  /*If the stage was already initialised the motion worker is stopped before
+  the ports are replaced, and started again below. */
+  StopMotionWorker(Stage);
+
 
 
   //Opening COM port to communicate with the V8849 motor control board.
   //Getting required parameters from the OMDAQ-3 parameters window.
-  port_nmr=atoi(options[0])-1;
-  taxabaud=atoi(options[1]);
-  std::strcpy(modo,options[2]);
+  Stage->taxabaud=atoi(options[1]);
+  std::strcpy(Stage->modo,options[2]);
 
   if(COMS) {
-	if(RS232_OpenComport(port_nmr, taxabaud, modo))
-  {
-	return(0);
+	std::lock_guard<std::mutex> port_lock(Stage->PortMutex);
+	delete Stage->port;
+	Stage->port = OpenSerialTransport(options[0], Stage->taxabaud, Stage->modo);
+	if(Stage->port == NULL)
+  {
+	return(0);
   }
 
-	//"New" order to erase any previous programs in the control board
-	string new_order_s = "new\n";
-	const char* new_order = new_order_s.data();
-	RS232_cputs(port_nmr, new_order);
+	/*"New" order to erase any previous programs in the control board,
+	including any angle sequence (see XyzLoadAngleSequence(...))*/
+	{
+	  std::lock_guard<std::mutex> lock(Stage->MotionMutex);
+	  Stage->SequenceSteps.clear();
+	  Stage->SequenceNext = 0;
+	  Stage->SequenceBoardNext = 0;
+	}
+	V8849Order new_order;
+	Stage->port->Puts(V8849New(&new_order));
 
   }
 
@@ -321,21 +877,21 @@ XYZ_DLL bool _CALLSTYLE_ XyzInitialise(char **options, int szOptions) {
 
   //Openning COM port to control current supply.
   //Getting required parameters from the OMDAQ-3 parameters window
-  port_nmrN=atoi(options[3])-1;
-  taxabaudN=atoi(options[4]);
-  std::strcpy(modoN,options[5]);
+  Stage->taxabaudN=atoi(options[4]);
+  std::strcpy(Stage->modoN,options[5]);
 
   if(COMS) {
 
-
-	if(RS232_OpenComport(port_nmrN, taxabaudN, modoN))
-  {
-	return(0);
+	delete Stage->portN;
+	Stage->portN = OpenSerialTransport(options[3], Stage->taxabaudN, Stage->modoN);
+	if(Stage->portN == NULL)
+  {
+	return(0);
   }
 
 	/*Order to turn motor OFF. The voltage level of the DTR pin of the
 	RS232 port controls the power of the motor.  */
-	RS232_disableDTR(port_nmrN);
+	Stage->portN->SetDTR(false);
 
   }
 
@@ -343,19 +899,19 @@ XYZ_DLL bool _CALLSTYLE_ XyzInitialise(char **options, int szOptions) {
 
 
 
-  /*Storing rotation speed in degrees per second in a global variable.
+  /*Storing rotation speed in degrees per second in the stage context.
   Value was obtained from the OMDAQ-3 parameters window */
-  RotSpeed[0]=atof(options[6]);
-  RotSpeed[1]=0;
-  RotSpeed[2]=0;
+  Stage->RotSpeed[0]=atof(options[6]);
+  Stage->RotSpeed[1]=0;
+  Stage->RotSpeed[2]=0;
 
   /*Setting the physical speed of the motor. First this value must be converted
   from degrees per second to motor steps per second */
-  steps_rev=atoi(options[7]);
+  Stage->steps_rev=atoi(options[7]);
   double rot_speed;
   double prescale=1;
 
-  rot_speed = RotSpeed[0]*steps_rev/360;
+  rot_speed = Stage->RotSpeed[0]*Stage->steps_rev/360;
   rot_speed = round(rot_speed);
 
 
@@ -383,51 +939,55 @@ XYZ_DLL bool _CALLSTYLE_ XyzInitialise(char **options, int szOptions) {
 
   if(rot_speed<63) {
 	rot_speed = 63 ;
-	RotSpeed[0] = rot_speed*prescale*steps_rev/360 ;
+	Stage->RotSpeed[0] = rot_speed*prescale*Stage->steps_rev/360 ;
   }
 
+  Stage->step_rate = rot_speed/prescale;
+  Stage->board_prescale = (long)prescale;
+  Stage->board_cvel = (long)rot_speed;
+
   //Prescaling, if necessary, so that velocities lower than 63 steps/second
   //can be reached.
+  V8849Order speed_order;
   if(prescale>1 && COMS){
 
-
-
-	string prescale_s;
-	prescale_s = to_string(prescale);
-	string::size_type ps = prescale_s.find(".");
-	prescale_s.erase(ps, string::npos);
-	string order_ps = "prescale("+prescale_s+")\n";
-	const char* order_ps2=order_ps.data();
-
-	RS232_cputs(port_nmr, order_ps2);
-
+	std::lock_guard<std::mutex> port_lock(Stage->PortMutex);
+	Stage->port->Puts(V8849Prescale(&speed_order, Stage->board_prescale));
 
   }
 
 
   //Sending the cvel(u) order to the V8849 control board
-  string rot_speed_s;
-  rot_speed_s=to_string(rot_speed);
-  string::size_type dot = rot_speed_s.find(".");
-  rot_speed_s.erase(dot, string::npos);
-  string order_rs = "cvel("+rot_speed_s+")\n";
-  const char* order_rs2=order_rs.data();
-
   if(COMS) {
 
-  RS232_cputs(port_nmr, order_rs2);
+  std::lock_guard<std::mutex> port_lock(Stage->PortMutex);
+  Stage->port->Puts(V8849Cvel(&speed_order, Stage->board_cvel));
 
   }
 
 
 
+  /*Power gating parameters. See XyzSetPowerGating(...) */
+  Stage->PowerHoldTime=atoi(options[8]);
+  Stage->PowerSettleTime=atoi(options[9]);
+
+
   //Storing the value of the motor's step in degrees
-  AngleStep[0]=360/steps_rev;
-  AngleStep[1]=0;
-  AngleStep[2]=0;
+  Stage->AngleStep[0]=360/Stage->steps_rev;
+  Stage->AngleStep[1]=0;
+  Stage->AngleStep[2]=0;
 
 
-  DllPowerOn = true;
+  //Starting the motion worker that executes the moves in the background
+  if(!Stage->MotionThread.joinable()) {
+	Stage->MotionQuit = false;
+	Stage->MotionThread = std::thread(MotionWorker, Stage);
+  }
+
+  std::lock_guard<std::mutex> lock(Stage->MotionMutex);
+  Stage->DllPowerOn = true;
+  Stage->MotionFault = false;
+  PublishState(Stage);
   return true;
 }
 
@@ -437,10 +997,31 @@ XYZ_DLL bool _CALLSTYLE_ XyzInitialise(char **options, int szOptions) {
 
    OMDAQ saves the position at shutdown ready for the next startup.
    Returns false if it fails. */
-XYZ_DLL bool _CALLSTYLE_ XyzShutDown() {
+XYZ_DLL bool _CALLSTYLE_ XyzCtxShutDown(XYZSTAGE Stage) {
 
-  /*This was not a needed funcionality
-	so this function was not used. */
+  /*The resources that must be freed are the motion worker and the COM
+  ports. If the motor is moving the worker stops waiting for it and turns the
+  motor off. This can't be done from the motion callback, which runs in the
+  worker. */
+
+  if(OnMotionThread(Stage)) {
+	return false;
+  }
+
+  StopMotionWorker(Stage);
+  {
+	std::lock_guard<std::mutex> lock(Stage->MotionMutex);
+	Stage->MotionCallback = NULL;
+	PublishState(Stage);
+  }
+
+  {
+	std::lock_guard<std::mutex> port_lock(Stage->PortMutex);
+	delete Stage->port;
+	Stage->port = NULL;
+  }
+  delete Stage->portN;
+  Stage->portN = NULL;
 
   return true;
 }
@@ -466,7 +1047,8 @@ in which case just return a true.
 Since the there are no linear positions for this stage this function doesn't
 do anything.
 .*/
-XYZ_DLL bool _CALLSTYLE_ XyzSetCurrentPosition(double * NewPosition) {
+XYZ_DLL bool _CALLSTYLE_ XyzCtxSetCurrentPosition(XYZSTAGE Stage,
+	double * NewPosition) {
 
 
 
@@ -497,7 +1079,7 @@ the DLL. This is only (I believe) in 2 situations:
 Note that this procedure is not required for stages with hardware zero markers,
 in which case just return a true.
  */
-XYZ_DLL bool _CALLSTYLE_ XyzSetCurrentAngle(double * NewAngle) {
+XYZ_DLL bool _CALLSTYLE_ XyzCtxSetCurrentAngle(XYZSTAGE Stage, double * NewAngle) {
 
 
   /*In this function the position of the motor is set to correspond
@@ -510,31 +1092,25 @@ XYZ_DLL bool _CALLSTYLE_ XyzSetCurrentAngle(double * NewAngle) {
   (V8849 RS Components).
   */
 
-  for (int i = 0; i < 3; ++i) {
-	CurrentDllAngle[i] = NewAngle[i];
-	DemandAngle[i] = NewAngle[i];
-  }
-
-  double n_angle;
-
-  /*Converting angle from degrees to motor
-   steps and storing the value in a string. */
-  n_angle=NewAngle[0]*steps_rev/360;
-  n_angle = round(n_angle);
-  string na0=to_string(n_angle);
-  string::size_type m = na0.find(".");
-  na0.erase(m, string::npos);
-
-  //Setting up const char* with the datum(axis,val) order
-  string order;
-  order="datum(0,"+na0+")\n";
-  const char* order2=order.data();
-
+  //Converting angle from degrees to motor steps
+  long n_angle = AngleToSteps(Stage, NewAngle[0]);
 
+  {
+	std::lock_guard<std::mutex> lock(Stage->MotionMutex);
+	for (int i = 0; i < 3; ++i) {
+	  Stage->CurrentDllAngle[i] = NewAngle[i];
+	  Stage->DemandAngle[i] = NewAngle[i];
+	}
+	Stage->BoardSteps = n_angle;
+	PublishState(Stage);
+  }
 
-  //Sending datum(axis,val) to the control board
+  /*Sending datum(axis,val) to the control board. The motion worker may be
+  asking the board for the position at the same time, see PortMutex. */
   if(COMS){
-  RS232_cputs(port_nmr, order2);
+  V8849Order order;
+  std::lock_guard<std::mutex> port_lock(Stage->PortMutex);
+  Stage->port->Puts(V8849Datum(&order, 0, n_angle));
   }
 
 
@@ -562,7 +1138,7 @@ acceleration and deceleration phases. Units are  mm/sec and mm/sec2.
 NewAccel and NewSpeed are pointers to double[3] arrays containing the new
 values for each axis. At present OMDAQ only allows a single acceleration value
 for all axes (possibly the first argument of NewAccel, NewAccel[0]?). */
-XYZ_DLL bool _CALLSTYLE_ XyzSetAccel(double * NewAccel) {
+XYZ_DLL bool _CALLSTYLE_ XyzCtxSetAccel(XYZSTAGE Stage, double * NewAccel) {
 
 	/*This was not a needed funcionality
 	so this function was not used. */
@@ -570,13 +1146,13 @@ XYZ_DLL bool _CALLSTYLE_ XyzSetAccel(double * NewAccel) {
   return true;
 }
 
-XYZ_DLL bool _CALLSTYLE_ XyzSetSpeed(double * NewSpeed) {
+XYZ_DLL bool _CALLSTYLE_ XyzCtxSetSpeed(XYZSTAGE Stage, double * NewSpeed) {
 
 	/*This was not a needed funcionality
 	so this function was not used. */
 
   for (int i = 0; i < 3; ++i) {
-	LinSpeed[i] = NewSpeed[i];
+	Stage->LinSpeed[i] = NewSpeed[i];
   }
   return true;
 }
@@ -589,7 +1165,7 @@ in the acceleration and deceleration phases. Units are  degrees/second (
 and degrees/second^2 (/s^2).
 NewSpeed and NewAccel are pointers to double[3] arrays containing the new
 values for each axis. */
-XYZ_DLL bool _CALLSTYLE_ XyzSetRotAccel(double * NewAccel) {
+XYZ_DLL bool _CALLSTYLE_ XyzCtxSetRotAccel(XYZSTAGE Stage, double * NewAccel) {
 
 	/*This was not a needed funcionality
 	so this function was not used.*/
@@ -598,7 +1174,7 @@ XYZ_DLL bool _CALLSTYLE_ XyzSetRotAccel(double * NewAccel) {
 }
 
 
-XYZ_DLL bool _CALLSTYLE_ XyzSetRotSpeed(double * NewSpeed) {
+XYZ_DLL bool _CALLSTYLE_ XyzCtxSetRotSpeed(XYZSTAGE Stage, double * NewSpeed) {
 
 	/*This function does not seem to be reading correctly the values of the
 	speed configured in OMDAQ-3, so in this DLL the speed value is provided
@@ -617,7 +1193,7 @@ XYZ_DLL bool _CALLSTYLE_ XyzSetRotSpeed(double * NewSpeed) {
  OMDAQ-3. If Enabled = true (false) the power should be turned ON
  (OFF) for all axes. It should leave the controller active and reporting.
  Returns true for success. */
-XYZ_DLL bool _CALLSTYLE_ XyzPowerOn(bool Enabled) {
+XYZ_DLL bool _CALLSTYLE_ XyzCtxPowerOn(XYZSTAGE Stage, bool Enabled) {
 
 /*
   The motor is powered on and off through a RS232 communication channel
@@ -632,13 +1208,13 @@ XYZ_DLL bool _CALLSTYLE_ XyzPowerOn(bool Enabled) {
 
   if(Enabled==true) {
 
-  RS232_enableDTR(port_nmrN);
+  portN->SetDTR(true);
 
   }
 
   else if(Enabled==false) {
 
-  RS232_disableDTR(port_nmrN);
+  portN->SetDTR(false);
 
   }
 
@@ -647,7 +1223,9 @@ XYZ_DLL bool _CALLSTYLE_ XyzPowerOn(bool Enabled) {
 
 
 
-  DllPowerOn = Enabled;
+  std::lock_guard<std::mutex> lock(Stage->MotionMutex);
+  Stage->DllPowerOn = Enabled;
+  PublishState(Stage);
   return true;
 }
 
@@ -670,7 +1248,8 @@ XYZ_DLL bool _CALLSTYLE_ XyzPowerOn(bool Enabled) {
  for the stage to reach it's position is handled by OMDAQ alone and not by the
  DLL.
 */
-XYZ_DLL bool _CALLSTYLE_ XyzMoveToPosition(double * NewPosition) {
+XYZ_DLL bool _CALLSTYLE_ XyzCtxMoveToPosition(XYZSTAGE Stage,
+	double * NewPosition) {
 
 
 
@@ -686,104 +1265,76 @@ XYZ_DLL bool _CALLSTYLE_ XyzMoveToPosition(double * NewPosition) {
 	*/
 
 
-  tLin = clock();
+  Stage->tLin = clock();
   return true;
 }
 
-XYZ_DLL bool _CALLSTYLE_ XyzMoveToAngle(double * NewAngle) {
+XYZ_DLL bool _CALLSTYLE_ XyzCtxMoveToAngle(XYZSTAGE Stage, double * NewAngle) {
 
 
 
-	/*This function sends a move order - "Cmove(val, axis)" - to the
+	/*This function requests a move order - "Cmove(val, axis)" - to the
 	programmable motor board. Cmove(val, axis) moves the motor number
 	"axis" (motor no. 0 or no. 1) to the position val, where the position
 	is absolute and in motor steps. For more details about this function
 	please check the Programmable Stepper Motor Control Board manual
 	(V8849 RS Components).
 
+	The move itself (turning the motor on, sending the order, waiting and
+	turning the motor off) is done by the motion worker, see MotionWorker(),
+	so this function returns immediately as OMDAQ-3 expects.
 	*/
 
 
 	/*
-	NOTE: The current angle is stored in an auxiliar variable, double
-	c_dll_angle, at the beggining of the function because sometimes OMDAQ
-	updates the double CurrentDllAngle[3] variable in the mid of the execution
-	of this function. It calls the XyzGetAngle(double * CurrentAngle) in a
-	different thread. The angles before and after motion, along with the speed
-	of the motor, are used to calculate the time that the motor must be ON so
-	that it can move, i.e., the time that the program must pause. If the
-	starting angle is not stored in an auxiliary variable there is no way to
-	calculate this time, stored in the float "time_sleep" variable, in
-	milliseconds, down below, since many times it would be equal to 0 due to
-	the unwanted update of the variable CurrentDllAngle[0].
+	The time that the motor must be ON, i.e. the time that the motion worker
+	must wait, is calculated by the worker from the position of the motor
+	known from the board and the target, see MotionWorker().
 	*/
 
-	double c_dll_angle=CurrentDllAngle[0];
-	double n_angle;
-
-
+	long n_angle;
 
 
-
-
-	for (int i = 0; i < 3; ++i) {
-		DemandAngle[i] = NewAngle[i];
-	}
-
 	/*
-	Setting up move order. Converting the required angle into number of
-	motor steps, in a double variable, and then converting the double into a
-	string without decimals places since the Cmove(val, axis) function only
-	accepts an integer number of steps.
+	Converting the required angle into number of motor steps, since the
+	Cmove(val, axis) function only accepts an integer number of steps.
 	*/
+	n_angle = AngleToSteps(Stage, NewAngle[0]);
 
-	n_angle=NewAngle[0]*steps_rev/360;
-	n_angle = round(n_angle);
-
-	string na0=to_string(n_angle);
-	string::size_type m = na0.find(".");
-	na0.erase(m, string::npos);
 
-	string order;
-	order="Cmove("+na0+",0)\n";
-	const char* order2=order.data();
-
-	//Turning motor on
-	if(COMS){
-	RS232_enableDTR(port_nmrN);
-	}
-
-	/*
-	Calculating the time that the program sleeps so that the motor is
-	correctly turned off only AFTER the motion is completed.
-	*/
-	float time_sleep;
-	time_sleep=abs(NewAngle[0]-c_dll_angle)/RotSpeed[0]*1000 +2000;
-
-	//Sending the move order
-	if(COMS){
-	RS232_cputs(port_nmr, order2);
-	}
-
-
-
-	Sleep(time_sleep);
-
-
-	//Turning the motor back off again
-	if(COMS) {
-	RS232_disableDTR(port_nmrN);
+	//Handing the move over to the motion worker
+	{
+	  std::lock_guard<std::mutex> lock(Stage->MotionMutex);
+	  for (int i = 0; i < 3; ++i) {
+		Stage->DemandAngle[i] = NewAngle[i];
+	  }
+	  Stage->MotionTargetSteps = n_angle;
+	  Stage->MotionFromSequence = false;
+	  if(Stage->SequenceNext < Stage->SequenceSteps.size() &&
+		  Stage->SequenceSteps[Stage->SequenceNext] == Stage->MotionTargetSteps) {
+		Stage->MotionFromSequence = true;
+		++Stage->SequenceNext;
+	  }
+	  Stage->MotionRequested = true;
+	  Stage->MotionBusy = true;
+
+	  /*The position that the motor is ordered to move to is the whole number
+	  of steps nearest to the required angle, so that is the angle reported
+	  by XyzGetAngle(...). */
+	  if(Stage->steps_rev > 0) {
+		Stage->CurrentDllAngle[0] = n_angle*360/Stage->steps_rev;
+	  }
+	  PublishState(Stage);
 	}
+	Stage->MotionWake.notify_one();
 
-
-	tRot = clock();
 	return true;
 }
 
 /* XyzHalt() is meant to perform an immediate halt (emergency stop, so no
 deceleration) on all axes
 */
-XYZ_DLL bool _CALLSTYLE_ XyzHalt() {
+XYZ_DLL bool _CALLSTYLE_ XyzCtxHalt(XYZSTAGE Stage) {
 	
 	/*This was not a needed funcionality
 	so this function was not used.*/
@@ -819,7 +1370,8 @@ XyzGetAngle(...) exports the closest approximation to the required position
 that the stepper motor is capable of, since that is the position that the
 function XyzMoveToAngle(...) orders the motor to move to.
 */
-XYZ_DLL bool _CALLSTYLE_ XyzGetPosition(double * CurrentPosition) {
+XYZ_DLL bool _CALLSTYLE_ XyzCtxGetPosition(XYZSTAGE Stage,
+	double * CurrentPosition) {
 
 
   /*
@@ -834,18 +1386,14 @@ XYZ_DLL bool _CALLSTYLE_ XyzGetPosition(double * CurrentPosition) {
 
   */
 
-  clock_t tNow = clock();
   for (int i = 0; i < 3; ++i) {
 	CurrentPosition[i]=0;
-	CurrentDllPosition[i]=0;
 }
-  tLin = tNow;
   return true;
 }
 
 
-XYZ_DLL bool _CALLSTYLE_ XyzGetAngle(double * CurrentAngle) {
-  clock_t tNow = clock();
+XYZ_DLL bool _CALLSTYLE_ XyzCtxGetAngle(XYZSTAGE Stage, double * CurrentAngle) {
 
   /*
 
@@ -857,65 +1405,16 @@ XYZ_DLL bool _CALLSTYLE_ XyzGetAngle(double * CurrentAngle) {
 
 
 
-  /*Step slightly smaller than real step just because of the (finite)
-  precision of doubles. This actualy is unnecessary with the current code...
-  */
-  double anglestep=AngleStep[0]-0.001*AngleStep[0];
-
-  if(DemandAngle[0]>CurrentDllAngle[0]){
-
-		/*Checking if the motor approximates more the required position
-		by defect (the value of the position angle is smaller than the required
-		position) or by excess (the value of the position angle is greater than
-		the required position).*/
+  /*The angle is calculated by XyzMoveToAngle(...) from the whole number of
+  steps nearest to the required angle (the same conversion is used in the
+  datum(axis,val) order of XyzSetCurrentAngle(...)) and read here from the
+  published state, so this function never waits for the motion worker. */
+  StageSnapshot state = Stage->Published.Read();
 
-		/*This "while" gets the closest approximation of the stage to the
-		required angle position, by defect.
-		*/
-		while ((DemandAngle[0]-CurrentDllAngle[0]) >= anglestep ) {
-			CurrentDllAngle[0]+= AngleStep[0];
-	  }
-
-
-	  /*After getting the closest approximation by defect, this "if" checks
-	  if the approximation by excess is better or worse than the one by defect.
-	 */
-	  if(abs(CurrentDllAngle[0]+AngleStep[0] - DemandAngle[0])<abs(CurrentDllAngle[0] - DemandAngle[0])) {
-
-		  CurrentDllAngle[0]+=AngleStep[0];
-	  }
-  }
-
-  else if(DemandAngle[0]<CurrentDllAngle[0]){
-
-
-		/*Checking if the motor approximates more the required position
-		by defect (the value of the position angle is smaller than the required
-		position) or by excess (the value of the position angle is greater than
-		the required position).*/
-
-		/*This "while" gets the closest approximation of the stage to the
-		required angle position, by excess.
-		*/
-		while ((CurrentDllAngle[0] - DemandAngle[0]) >= anglestep ) {
-			CurrentDllAngle[0]-= AngleStep[0];
-	  }
-
-	  /*After getting the closest approximation by excess, this "if" checks
-	  if the approximation by defect is better or worse than the one by excess.
-	 */
-	  if(abs(CurrentDllAngle[0]-AngleStep[0] - DemandAngle[0])<abs(CurrentDllAngle[0] - DemandAngle[0])) {
-
-		  CurrentDllAngle[0]-=AngleStep[0];
-	  }
-
-  }
-
-  CurrentAngle[0] =CurrentDllAngle[0];
+  CurrentAngle[0] =state.CurrentAngle[0];
   CurrentAngle[1]=0;
   CurrentAngle[2]=0;
 
-  tRot = tNow;
   return true;
 }
 
@@ -928,24 +1427,25 @@ XYZ_DLL bool _CALLSTYLE_ XyzGetAngle(double * CurrentAngle) {
  Of course that there must be a temperature sensor in the motors for this
  function to be useful.
 */
-XYZ_DLL bool _CALLSTYLE_ XyzGetMotorTemp(double *MotorTemp, int iAxis) {
+XYZ_DLL bool _CALLSTYLE_ XyzCtxGetMotorTemp(XYZSTAGE Stage, double *MotorTemp,
+	int iAxis) {
 
 	/*This was not a needed funcionality
 	so this function was not used.*/
 
+  if (iAxis >= 6) {
+	return false;
+  }
   int iMin = 0;
   int iMax = 6;
   if (iAxis >= 0) {
 	iMin = iAxis;
-	iMax = iAxis;
+	iMax = iAxis + 1;
   }
   for (int i = iMin; i < iMax; ++i) {
-	int iDest = 0;
-	if (iAxis >= 0) {
-	  iDest = i;
-	}
-	MotorTemp[iDest] = 25 + 0.01 * random(500);
+	MotorTemp[i - iMin] = 25 + 0.01 * random(500);
   }
+  return true;
 }
 
 
@@ -954,8 +1454,8 @@ stage by calling the function XyzAxisStatus(int iAxis, DWORD * AxisStatus)
 with iAxis=-1. Please read the description of the XyzAxisStatus(...) function
 below.
 */
-XYZ_DLL DRVSTAT _CALLSTYLE_ XyzStageStatus(DWORD * AxisStatus) {
-  return XyzAxisStatus(-1, AxisStatus);
+XYZ_DLL DRVSTAT _CALLSTYLE_ XyzCtxStageStatus(XYZSTAGE Stage, DWORD * AxisStatus) {
+  return XyzCtxAxisStatus(Stage, -1, AxisStatus);
 }
 
 
@@ -975,11 +1475,10 @@ status is then equal to 1000000010000000100000000000
 */
 
 /*
-If iAxis = -1 the status of all axes is returned and, in theory, if 0<=iAxis<=5
-only the status of axis number iAxis is returned. However the code, as provided
-with OMDAQ-3 (3.2.4.1009), does NOT work with 0<=iAxis<=5 and XyzAxisStatus
-is always called from OMDAQ-3 with iAxis=-1. Geoff Grime is probably expecting
-to use this feature with some future version of OMDAQ-3.
+If iAxis = -1 the status of all axes is returned and if 0<=iAxis<=5 only the
+status of axis number iAxis is returned. The code, as provided with OMDAQ-3
+(3.2.4.1009), did NOT work with 0<=iAxis<=5, but XyzAxisStatus is always
+called from OMDAQ-3 with iAxis=-1. Other host programs may poll a single axis.
 */
 
 /*
@@ -995,10 +1494,13 @@ axis segments of status are filled so this must be managed in the calling
 program."
 
 Maybe an experiment for a future version of OMDAQ-3 ? I don't think that this
-is used for now.
+is used for now. If the pointer is not NULL each axis reported gets a detail
+word made of the AX_... flags of OmXyzDllExt.h. The missing axes are reported
+as AX_MISSING.
  
 */
-XYZ_DLL DRVSTAT _CALLSTYLE_ XyzAxisStatus(int iAxis, DWORD * AxisStatus) {
+XYZ_DLL DRVSTAT _CALLSTYLE_ XyzCtxAxisStatus(XYZSTAGE Stage, int iAxis,
+	DWORD * AxisStatus) {
 
 
   /*In the original code provided with OMDAQ-3 this
@@ -1026,65 +1528,13 @@ XYZ_DLL DRVSTAT _CALLSTYLE_ XyzAxisStatus(int iAxis, DWORD * AxisStatus) {
 
   */
 
-  DRVSTAT status = 0;
-  int iMin = 0;
-  int iMax = 6;
-  if (iAxis >= 0) {
-	iMin = iAxis;
-	iMax = iAxis;
+  if (iAxis >= 6) {
+	return 0;
   }
-  for (int i = iMin; i < iMax; ++i) {
-	if (i < 3) {
-
-		switch (i) {
-		case 0:
-		  status = status | ST_AX1_INPOSITION;
-		  break;
-		case 1:
-		  status = status | ST_AX2_INPOSITION;
-		  break;
-		case 2:
-		  status = status | ST_AX3_INPOSITION;
-		  break;
-		}
-
-	}
-	else {
-	  if (fabs(CurrentDllAngle[i - 3] - DemandAngle[i - 3]) > AngleStep[i-3]) {
-		switch (i - 3) {
-		case 0:
-		  status = status | ST_RO1_MOVING;
-		  break;
-		case 1:
-		  break;
-		case 2:
-		  break;
-		}
-	  }
-	  else {
-		switch (i - 3) {
-		case 0:
-		  status = status | ST_RO1_INPOSITION;
-		  break;
-		case 1:
-		  break;
-		case 2:
-		  break;
-		}
-	  }
-
 
-	  }
-
-
-	}
-
-
-  //All motors on
-  if (DllPowerOn) {
-	status |= (ST_ALL_XYZ_MOTORS_ON | ST_ALL_R1_MOTORS_ON);
-  }
-  return status;
+  /*The state is read once, so all the axes are reported from the same
+  state. */
+  return ReportedStatus(Stage->Published.Read(), iAxis, AxisStatus);
 }
 
 /********************************** End of routines for stage status reporting **********************************************/
@@ -1107,12 +1557,16 @@ XYZ_DLL DRVSTAT _CALLSTYLE_ XyzAxisStatus(int iAxis, DWORD * AxisStatus) {
  (in which case OMDAQ will try to do a tidy shutdown)
  XyzFtlAckRetry 2    - I may be able to clear the fault if you try again,
 */
-XYZ_DLL int _CALLSTYLE_ XyzFaultAck() {
+XYZ_DLL int _CALLSTYLE_ XyzCtxFaultAck(XYZSTAGE Stage) {
 
 
-	/*This was not a needed funcionality
-	so this function was not used.*/
+	/*The only fault reported is a move that the board didn't confirm in
+	time (see MotionWorker()). It is cleared here; the next move tells if the
+	board is answering again. */
 
+  std::lock_guard<std::mutex> lock(Stage->MotionMutex);
+  Stage->MotionFault = false;
+  PublishState(Stage);
   return XyzFltAckOK;
 }
 
@@ -1127,13 +1581,438 @@ XYZ_DLL int _CALLSTYLE_ XyzFaultAck() {
 
  return true for success.
 */
-XYZ_DLL bool _CALLSTYLE_ XyzLastFaultText(char *statusText, int nChar) {
+XYZ_DLL bool _CALLSTYLE_ XyzCtxLastFaultText(XYZSTAGE Stage, char *statusText,
+	int nChar) {
 
-	/*This was not a needed funcionality
-	so this function was not used.*/
+  StageSnapshot state = Stage->Published.Read();
+  if(state.MotionFault) {
+	strncpy(statusText, "The V8849 board did not confirm the target position",
+		nChar);
+	return true;
+  }
 
   strcpy(statusText, "Fault?  What fault?");
   return true;
 }
 //
 // *************************************************************************
+
+
+
+
+/********************************** Extended routines (OmXyzDllExt.h) **********************************************/
+
+
+/* XyzCreateStage() creates a new stage context, independent of the default
+stage used by the OMDAQ-3 routines. It must be initialised with
+XyzCtxInitialise(...), with the COM ports of its own board, like the default
+stage. Returns NULL if there is no memory. */
+XYZ_DLL XYZSTAGE _CALLSTYLE_ XyzCreateStage() {
+
+  return new(std::nothrow) XyzStage;
+}
+
+
+/* XyzDestroyStage(...) shuts down a stage created by XyzCreateStage() (see
+XyzShutDown()) and frees it. The default stage cannot be destroyed, and a stage
+cannot be destroyed from its own motion callback. */
+XYZ_DLL bool _CALLSTYLE_ XyzDestroyStage(XYZSTAGE Stage) {
+
+  if(Stage == NULL || Stage == &DefaultStage || OnMotionThread(Stage)) {
+	return false;
+  }
+
+  XyzCtxShutDown(Stage);
+  delete Stage;
+  return true;
+}
+
+
+/* XyzCtxSetPowerGating(...) sets the time, in milliseconds, that the motor is
+kept powered after a move (holdTime) and the time that the motor needs to
+settle after being powered (settleTime). Negative values are not accepted. */
+XYZ_DLL bool _CALLSTYLE_ XyzCtxSetPowerGating(XYZSTAGE Stage, int holdTime,
+	int settleTime) {
+
+  if(holdTime < 0 || settleTime < 0) {
+	return false;
+  }
+
+  std::lock_guard<std::mutex> lock(Stage->MotionMutex);
+  Stage->PowerHoldTime = holdTime;
+  Stage->PowerSettleTime = settleTime;
+  return true;
+}
+
+
+/* XyzCtxAcquisitionStarting(...) is called by the host just before data is
+acquired. If the motor is being held powered after a move it is turned off
+now, and this function only returns after the motor is off (or after 1 second
+if the worker doesn't answer). If a move is in progress the request is kept
+and the worker turns the motor off as soon as the move ends, without the hold
+time, but this function returns at once. */
+XYZ_DLL bool _CALLSTYLE_ XyzCtxAcquisitionStarting(XYZSTAGE Stage) {
+
+  std::unique_lock<std::mutex> lock(Stage->MotionMutex);
+  if(!Stage->MotorEnergized && !Stage->MotionBusy) {
+	return true;
+  }
+
+  Stage->PowerGateRequested = true;
+  Stage->MotionWake.notify_all();
+  if(Stage->MotionBusy) {
+	return true;
+  }
+  return Stage->MotionWake.wait_for(lock, std::chrono::milliseconds(1000),
+	  [Stage] { return !Stage->MotorEnergized || Stage->MotionBusy; });
+}
+
+
+/* XyzCtxLoadAngleSequence(...) loads a list of n angles (degrees) in the
+V8849 board as a program, so that later each projection only needs a short
+order instead of a full "Cmove(val,0)" order. The program is:
+
+  new
+  prescale(p)            (only if the prescale factor is needed)
+  cvel(u)
+  int seq[n];
+  seq[0]=val0;
+  ...
+  seq[n-1]=valn-1;
+  int iseq;
+  iseq=0;
+  void adv(){Cmove(seq[iseq],0);iseq=iseq+1;}
+
+where the values are the angles converted to motor steps, as in
+XyzMoveToAngle(...). The "new" order erases any previous program, so the
+speed orders sent by XyzInitialise(...) are sent again.
+After loading, when XyzMoveToAngle(...) is called with the next angle of the
+sequence the motion worker sends "adv()" instead of the Cmove order. Calls with
+any other angle are sent as Cmove orders and don't advance the sequence. If
+several moves of the sequence are merged by the worker the target is sent as a
+Cmove order followed by "iseq=i;", so the board stays at the same position of
+the sequence as the host.
+Calling this function with n = 0 removes the sequence.
+The sequence is changed with MotionMutex locked, but the orders are sent
+after unlocking it, since at 9600 baud they take some seconds and the status
+functions and XyzMoveToAngle(...) must not wait for them. PortMutex is held
+until the program is loaded, so a move requested meanwhile is sent after it.
+Returns false if a move is in progress. */
+XYZ_DLL bool _CALLSTYLE_ XyzCtxLoadAngleSequence(XYZSTAGE Stage,
+	const double *angles, int n) {
+
+  if(n < 0 || (n > 0 && angles == NULL)) {
+	return false;
+  }
+
+  std::vector<long> steps;
+  for (int i = 0; i < n; ++i) {
+	steps.push_back(AngleToSteps(Stage, angles[i]));
+  }
+
+  std::lock_guard<std::mutex> port_lock(Stage->PortMutex);
+  std::unique_lock<std::mutex> lock(Stage->MotionMutex);
+  if(Stage->MotionBusy) {
+	return false;
+  }
+
+  Stage->SequenceSteps = steps;
+  Stage->SequenceNext = 0;
+  Stage->SequenceBoardNext = 0;
+  long prescale = Stage->board_prescale;
+  long cvel = Stage->board_cvel;
+  lock.unlock();
+
+  if(n == 0) {
+	return true;
+  }
+
+  if(COMS) {
+
+	V8849Order order;
+	Stage->port->Puts(V8849New(&order));
+	if(prescale>1) {
+	  Stage->port->Puts(V8849Prescale(&order, prescale));
+	}
+	Stage->port->Puts(V8849Cvel(&order, cvel));
+
+	Stage->port->Puts(V8849SeqDeclare(&order, n));
+	for (int i = 0; i < n; ++i) {
+	  Stage->port->Puts(V8849SeqEntry(&order, i, steps[i]));
+	}
+	Stage->port->Puts(V8849SeqIndexDeclare(&order));
+	Stage->port->Puts(V8849SeqIndexSet(&order, 0));
+	Stage->port->Puts(V8849SeqFunction(&order, 0));
+  }
+
+  return true;
+}
+
+
+/* XyzCtxSerialLatency(...) returns the number of position queries sent to the
+board and the mean and maximum time (ms) between sending a query and receiving
+the answer. */
+XYZ_DLL bool _CALLSTYLE_ XyzCtxSerialLatency(XYZSTAGE Stage, int *nQueries,
+	double *meanTime, double *maxTime, bool reset) {
+
+  std::lock_guard<std::mutex> lock(Stage->MotionMutex);
+  *nQueries = Stage->QueryCount;
+  *meanTime = (Stage->QueryCount > 0) ? Stage->QueryTimeTotal/Stage->QueryCount : 0;
+  *maxTime = Stage->QueryTimeMax;
+  if(reset) {
+	Stage->QueryCount = 0;
+	Stage->QueryTimeTotal = 0;
+	Stage->QueryTimeMax = 0;
+  }
+  return true;
+}
+
+
+/* XyzCtxPowerGatingCounters(...) returns the power gating counters: number of
+times the motor was powered up, number of power cycles avoided because the
+next move arrived within the hold time, and the settle time saved (ms). */
+XYZ_DLL bool _CALLSTYLE_ XyzCtxPowerGatingCounters(XYZSTAGE Stage,
+	int *powerUps, int *togglesAvoided, double *timeSaved, bool reset) {
+
+  std::lock_guard<std::mutex> lock(Stage->MotionMutex);
+  *powerUps = Stage->PowerUps;
+  *togglesAvoided = Stage->PowerTogglesAvoided;
+  *timeSaved = Stage->PowerTimeSaved;
+  if(reset) {
+	Stage->PowerUps = 0;
+	Stage->PowerTogglesAvoided = 0;
+	Stage->PowerTimeSaved = 0;
+  }
+  return true;
+}
+
+
+/* XyzCtxGetSnapshot(...) returns in one call what XyzGetPosition(...),
+XyzGetAngle(...), XyzStageStatus(...) and XyzGetMotorTemp(...) return. All the
+values come from one reading of the published state, so they are consistent
+with each other, and no order is sent to the board. The time is the time of
+the steady clock of the C++ library, in seconds. */
+XYZ_DLL bool _CALLSTYLE_ XyzCtxGetSnapshot(XYZSTAGE Stage,
+	struct XyzSnapshot *Snapshot) {
+
+  StageSnapshot state = Stage->Published.Read();
+  Snapshot->Time = std::chrono::duration<double>(
+	  std::chrono::steady_clock::now().time_since_epoch()).count();
+
+  //Only the first rotation axis exists, see XyzGetPosition(...)
+  for (int i = 0; i < 3; ++i) {
+	Snapshot->Position[i] = 0;
+	Snapshot->Angle[i] = 0;
+  }
+  Snapshot->Angle[0] = state.CurrentAngle[0];
+
+  //Same (made up) values as XyzGetMotorTemp(...)
+  for (int i = 0; i < 6; ++i) {
+	Snapshot->MotorTemp[i] = 25 + 0.01 * random(500);
+  }
+
+  Snapshot->Status = ReportedStatus(state, -1, Snapshot->AxisStatus);
+  return true;
+}
+
+
+/* XyzCtxStatusDelta(...) is XyzStageStatus(...) for host programs that poll
+the status at a high rate. The generation is the number of states published
+by PublishState(...) (see SeqLock.h). The status of this stage only depends on
+the published state, so if the generation didn't change since the last call
+nothing changed and the function returns at once. */
+XYZ_DLL bool _CALLSTYLE_ XyzCtxStatusDelta(XYZSTAGE Stage,
+	unsigned *Generation, DRVSTAT *Status, DRVSTAT *Changed,
+	int *ChangedAxes) {
+
+  *Changed = 0;
+  *ChangedAxes = 0;
+  if(Stage->Published.Generation() == *Generation) {
+	return false;
+  }
+
+  StageSnapshot state = Stage->Published.Read(Generation);
+  DRVSTAT new_status = ReportedStatus(state, -1, NULL);
+  *Changed = new_status ^ *Status;
+  *Status = new_status;
+  for (int i = 0; i < 6; ++i) {
+	*ChangedAxes |= (int)(((*Changed >> XyzStatusShift[i]) & 0xFF) != 0) << i;
+  }
+  return *Changed != 0;
+}
+
+
+/* XyzCtxWaitStatusChange(...) is for host programs that would otherwise call
+XyzStageStatus(...) in a loop until e.g. the end of a move. The status of this
+stage only changes when the state is published, so the function sleeps on
+StatusChanged and checks the status again each time it is signalled. */
+XYZ_DLL bool _CALLSTYLE_ XyzCtxWaitStatusChange(XYZSTAGE Stage, DRVSTAT Mask,
+	int Timeout, DRVSTAT *Status) {
+
+  std::unique_lock<std::mutex> lock(Stage->MotionMutex);
+  DRVSTAT start = ReportedStatus(Stage->Published.Read(), -1, NULL);
+  DRVSTAT new_status = start;
+  bool changed = Stage->StatusChanged.wait_for(lock,
+	  std::chrono::milliseconds(Timeout), [&] {
+	  new_status = ReportedStatus(Stage->Published.Read(), -1, NULL);
+	  return ((new_status ^ start) & Mask) != 0; });
+  if(Status != NULL) {
+	*Status = new_status;
+  }
+  return changed;
+}
+
+
+/* XyzCtxSetMotionCallback(...) sets the routine called by the motion worker
+when the board confirms that the motor reached the target step (see
+MotionWorker()), with ST_RO1_INPOSITION as the event, or with ST_RO1_HWFAULT
+when the board doesn't confirm it in time. The stage has no limit switches,
+so limit events never happen.
+The worker calls the callback without MotionMutex, so when the callback is
+changed the worker may still be calling the old one. To be sure that it is no
+longer called the function waits until the call has returned, unless it is
+called from the callback itself. */
+XYZ_DLL bool _CALLSTYLE_ XyzCtxSetMotionCallback(XYZSTAGE Stage,
+	XyzMotionCallback Callback, void *User) {
+
+  std::unique_lock<std::mutex> lock(Stage->MotionMutex);
+  Stage->MotionCallback = Callback;
+  Stage->MotionCallbackUser = User;
+  if(!OnMotionThread(Stage)) {
+	Stage->MotionWake.wait(lock,
+		[Stage] { return !Stage->MotionCallbackActive; });
+  }
+  return true;
+}
+
+
+
+/********************************** OMDAQ-3 routines on the default stage **********************************************/
+
+
+/* The routines of OmXyzDll.h and OmXyzDllExt.h work on DefaultStage. See the
+XyzCtx... routines above for the details. */
+
+XYZ_DLL bool _CALLSTYLE_ XyzOptionValue(int nHdr, char * optionVal,
+	int szOptionVal) {
+  return XyzCtxOptionValue(&DefaultStage, nHdr, optionVal, szOptionVal);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzInitialise(char **options, int szOptions) {
+  return XyzCtxInitialise(&DefaultStage, options, szOptions);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzShutDown() {
+  return XyzCtxShutDown(&DefaultStage);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzSetCurrentPosition(double * NewPosition) {
+  return XyzCtxSetCurrentPosition(&DefaultStage, NewPosition);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzSetCurrentAngle(double * NewAngle) {
+  return XyzCtxSetCurrentAngle(&DefaultStage, NewAngle);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzSetAccel(double * NewAccel) {
+  return XyzCtxSetAccel(&DefaultStage, NewAccel);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzSetSpeed(double * NewSpeed) {
+  return XyzCtxSetSpeed(&DefaultStage, NewSpeed);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzSetRotAccel(double * NewAccel) {
+  return XyzCtxSetRotAccel(&DefaultStage, NewAccel);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzSetRotSpeed(double * NewSpeed) {
+  return XyzCtxSetRotSpeed(&DefaultStage, NewSpeed);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzPowerOn(bool Enabled) {
+  return XyzCtxPowerOn(&DefaultStage, Enabled);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzMoveToPosition(double * NewPosition) {
+  return XyzCtxMoveToPosition(&DefaultStage, NewPosition);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzMoveToAngle(double * NewAngle) {
+  return XyzCtxMoveToAngle(&DefaultStage, NewAngle);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzHalt() {
+  return XyzCtxHalt(&DefaultStage);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzGetPosition(double * CurrentPosition) {
+  return XyzCtxGetPosition(&DefaultStage, CurrentPosition);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzGetAngle(double * CurrentAngle) {
+  return XyzCtxGetAngle(&DefaultStage, CurrentAngle);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzGetMotorTemp(double *MotorTemp, int iAxis) {
+  return XyzCtxGetMotorTemp(&DefaultStage, MotorTemp, iAxis);
+}
+
+XYZ_DLL DRVSTAT _CALLSTYLE_ XyzStageStatus(DWORD * AxisStatus) {
+  return XyzCtxStageStatus(&DefaultStage, AxisStatus);
+}
+
+XYZ_DLL DRVSTAT _CALLSTYLE_ XyzAxisStatus(int iAxis, DWORD * AxisStatus) {
+  return XyzCtxAxisStatus(&DefaultStage, iAxis, AxisStatus);
+}
+
+XYZ_DLL int _CALLSTYLE_ XyzFaultAck() {
+  return XyzCtxFaultAck(&DefaultStage);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzLastFaultText(char *statusText, int nChar) {
+  return XyzCtxLastFaultText(&DefaultStage, statusText, nChar);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzSetPowerGating(int holdTime, int settleTime) {
+  return XyzCtxSetPowerGating(&DefaultStage, holdTime, settleTime);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzAcquisitionStarting() {
+  return XyzCtxAcquisitionStarting(&DefaultStage);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzLoadAngleSequence(const double *angles, int n) {
+  return XyzCtxLoadAngleSequence(&DefaultStage, angles, n);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzSerialLatency(int *nQueries, double *meanTime,
+	double *maxTime, bool reset) {
+  return XyzCtxSerialLatency(&DefaultStage, nQueries, meanTime, maxTime, reset);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzPowerGatingCounters(int *powerUps,
+	int *togglesAvoided, double *timeSaved, bool reset) {
+  return XyzCtxPowerGatingCounters(&DefaultStage, powerUps, togglesAvoided,
+	  timeSaved, reset);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzGetSnapshot(struct XyzSnapshot *Snapshot) {
+  return XyzCtxGetSnapshot(&DefaultStage, Snapshot);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzStatusDelta(unsigned *Generation, DRVSTAT *Status,
+	DRVSTAT *Changed, int *ChangedAxes) {
+  return XyzCtxStatusDelta(&DefaultStage, Generation, Status, Changed,
+	  ChangedAxes);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzWaitStatusChange(DRVSTAT Mask, int Timeout,
+	DRVSTAT *Status) {
+  return XyzCtxWaitStatusChange(&DefaultStage, Mask, Timeout, Status);
+}
+
+XYZ_DLL bool _CALLSTYLE_ XyzSetMotionCallback(XyzMotionCallback Callback,
+	void *User) {
+  return XyzCtxSetMotionCallback(&DefaultStage, Callback, User);
+}
@@ -0,0 +1,187 @@
+///--------------------------------------------------------------------------
+// OMXYZDLLEXT.H
+// Declarations of the extended functions exported from the tomography
+// OMXYZDLL.DLL.
+//
+// These calls are not part of the OMDAQ-3 interface defined in OmXyzDll.h
+// (which must not be changed). They are used by host programs that know about
+// this DLL and want more control over the stage than OMDAQ-3 needs.
+// OmXyzDll.h must be included before this file.
+// ---------------------------------------------------------------------------
+
+#ifndef OmXyzDllExtH
+#define OmXyzDllExtH
+
+// A stage context.  Each XYZSTAGE is a separate stage with its own motor
+// board, COM ports and motion worker, so one program can drive several
+// stages.  The OMDAQ-3 calls of OmXyzDll.h work on a default stage.
+typedef struct XyzStage *XYZSTAGE;
+
+#include "../DLL_omdaq_common/XyzStatusLayout.h"
+
+// The V8849 board moves at constant speed, so of the motion phases of the
+// axis detail words this DLL only reports AX_CONST_SPEED.  XyzSnapshot.Time
+// is the time (s) of a monotonic clock when the state was taken.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  // Power gating +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  //
+  // The motor is kept powered for holdTime milliseconds after a move is
+  // completed. If the next move arrives within this window the motor is not
+  // turned off and on again.  settleTime is the time (ms) the motor needs after
+  // being powered before it can move.  Both are also set by the "Hold time" and
+  // "Settle time" options of XyzInitialise.  holdTime = 0 turns the motor off
+  // as soon as each move is completed.
+  XYZ_DLL bool _CALLSTYLE_ XyzSetPowerGating(int holdTime, int settleTime);
+  //
+  // XyzAcquisitionStarting turns the motor off immediately (ending any hold
+  // window) so that no electromagnetic noise reaches the acquisition.  During
+  // a move it returns at once and the motor is turned off when the move ends.
+  XYZ_DLL bool _CALLSTYLE_ XyzAcquisitionStarting();
+  //
+  // XyzPowerGatingCounters returns the number of times the motor was powered
+  // up, the number of power cycles avoided by the hold window and the time
+  // saved (ms) by not waiting for the motor to settle.
+  // The counters are cleared if reset = true.
+  XYZ_DLL bool _CALLSTYLE_ XyzPowerGatingCounters(int *powerUps,
+	  int *togglesAvoided, double *timeSaved, bool reset = false);
+  //
+  // +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+  // Serial link +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  //
+  // XyzSerialLatency returns the number of position queries sent to the motor
+  // board and the mean and maximum round trip time (ms) of the queries.
+  // The statistics are cleared if reset = true.
+  XYZ_DLL bool _CALLSTYLE_ XyzSerialLatency(int *nQueries, double *meanTime,
+	  double *maxTime, bool reset = false);
+  //
+  // +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+  // Angle sequences ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  //
+  // XyzLoadAngleSequence loads the n angles (degrees) of a scan in the motor
+  // board as a program.  Afterwards, each XyzMoveToAngle call that asks for the
+  // next angle of the sequence is sent to the board as a single short order.
+  // Calls with other angles are sent as normal moves.
+  // n = 0 removes the sequence.  Returns false if the stage is moving.
+  XYZ_DLL bool _CALLSTYLE_ XyzLoadAngleSequence(const double *angles, int n);
+  //
+  // +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+  // Stage snapshot +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  //
+  // XyzGetSnapshot returns in one call what XyzGetPosition, XyzGetAngle,
+  // XyzStageStatus and XyzGetMotorTemp return, all taken from the same state
+  // of the stage, so the values are always consistent with each other.
+  XYZ_DLL bool _CALLSTYLE_ XyzGetSnapshot(struct XyzSnapshot *Snapshot);
+  //
+  // +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+  // Status polling +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  //
+  // XyzStatusDelta is XyzStageStatus for programs that poll at a high rate.
+  // Generation and Status must hold what the previous call returned (0 and 0
+  // for the first call).  If nothing changed since then it returns false at
+  // once, without working out the status.  Otherwise it updates Generation
+  // and Status and returns in Changed the status bits that changed and in
+  // ChangedAxes a bit (1 << i) for each axis i (0 to 5) with changed bits.
+  // It returns true if any bit changed.
+  XYZ_DLL bool _CALLSTYLE_ XyzStatusDelta(unsigned *Generation,
+	  DRVSTAT *Status, DRVSTAT *Changed, int *ChangedAxes);
+  //
+  // XyzWaitStatusChange waits, without polling, until any bit of Mask in the
+  // stage status changes (e.g. ST_ANY_R1_MOVING when a move ends) or until
+  // Timeout milliseconds have passed.  It returns the status in Status (if
+  // not NULL) and true if a bit of Mask changed, false after the timeout.
+  XYZ_DLL bool _CALLSTYLE_ XyzWaitStatusChange(DRVSTAT Mask, int Timeout,
+	  DRVSTAT *Status = NULL);
+  //
+  // +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+  // Motion callback ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  //
+  // XyzSetMotionCallback makes the stage call Callback(User, ...) from its own
+  // thread as soon as an axis reaches its target, hits a limit or faults, so
+  // that the host doesn't have to poll for the end of a move.  NULL removes
+  // the callback; once XyzSetMotionCallback returns it is no longer called.
+  // XyzShutDown also removes it.  Callback must return quickly.  It may call
+  // the other routines, XyzSetMotionCallback included, but not XyzInitialise,
+  // XyzShutDown or XyzDestroyStage on its own stage, which then return false.
+  XYZ_DLL bool _CALLSTYLE_ XyzSetMotionCallback(XyzMotionCallback Callback,
+	  void *User);
+  //
+  // +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+  // Stage contexts +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  //
+  // XyzCreateStage returns a new stage (NULL if it fails), which must be
+  // initialised with XyzCtxInitialise.  XyzDestroyStage shuts it down and
+  // frees it.  The default stage can't be destroyed.
+  XYZ_DLL XYZSTAGE _CALLSTYLE_ XyzCreateStage();
+  XYZ_DLL bool _CALLSTYLE_ XyzDestroyStage(XYZSTAGE Stage);
+  //
+  // The XyzCtx calls are the calls of OmXyzDll.h and of this file on a given
+  // stage.  The calls that don't depend on the stage (capabilities, version,
+  // descriptions and option headers) have no XyzCtx version.
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxOptionValue(XYZSTAGE Stage, int nHdr,
+	  char * optionVal, int szOptionVal);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxInitialise(XYZSTAGE Stage, char **options,
+	  int szOptions);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxShutDown(XYZSTAGE Stage);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxSetCurrentPosition(XYZSTAGE Stage,
+	  double * NewPosition);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxSetCurrentAngle(XYZSTAGE Stage,
+	  double * NewAngle);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxSetAccel(XYZSTAGE Stage, double * NewAccel);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxSetSpeed(XYZSTAGE Stage, double * NewSpeed);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxSetRotAccel(XYZSTAGE Stage, double * NewAccel);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxSetRotSpeed(XYZSTAGE Stage, double * NewSpeed);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxPowerOn(XYZSTAGE Stage, bool Enabled);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxMoveToPosition(XYZSTAGE Stage,
+	  double * NewPosition);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxMoveToAngle(XYZSTAGE Stage, double * NewAngle);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxHalt(XYZSTAGE Stage);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxGetPosition(XYZSTAGE Stage,
+	  double * CurrentPosition);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxGetAngle(XYZSTAGE Stage, double * CurrentAngle);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxGetMotorTemp(XYZSTAGE Stage, double *MotorTemp,
+	  int iAxis);
+  XYZ_DLL DRVSTAT _CALLSTYLE_ XyzCtxStageStatus(XYZSTAGE Stage,
+	  DWORD * AxisStatus);
+  XYZ_DLL DRVSTAT _CALLSTYLE_ XyzCtxAxisStatus(XYZSTAGE Stage, int iAxis,
+	  DWORD * AxisStatus);
+  XYZ_DLL int _CALLSTYLE_ XyzCtxFaultAck(XYZSTAGE Stage);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxLastFaultText(XYZSTAGE Stage, char *statusText,
+	  int nChar);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxSetPowerGating(XYZSTAGE Stage, int holdTime,
+	  int settleTime);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxAcquisitionStarting(XYZSTAGE Stage);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxPowerGatingCounters(XYZSTAGE Stage,
+	  int *powerUps, int *togglesAvoided, double *timeSaved,
+	  bool reset = false);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxSerialLatency(XYZSTAGE Stage, int *nQueries,
+	  double *meanTime, double *maxTime, bool reset = false);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxLoadAngleSequence(XYZSTAGE Stage,
+	  const double *angles, int n);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxGetSnapshot(XYZSTAGE Stage,
+	  struct XyzSnapshot *Snapshot);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxStatusDelta(XYZSTAGE Stage,
+	  unsigned *Generation, DRVSTAT *Status, DRVSTAT *Changed,
+	  int *ChangedAxes);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxWaitStatusChange(XYZSTAGE Stage, DRVSTAT Mask,
+	  int Timeout, DRVSTAT *Status = NULL);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxSetMotionCallback(XYZSTAGE Stage,
+	  XyzMotionCallback Callback, void *User);
+  //
+  // +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#ifdef __cplusplus
+} // End of extern "C"
+#endif
+
+#endif
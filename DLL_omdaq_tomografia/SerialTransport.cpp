@@ -0,0 +1,236 @@
+// ---------------------------------------------------------------------------
+/* SerialTransport.cpp
+
+ Backends of the serial port used by the tomography DLL. See
+ SerialTransport.h
+ ---------------------------------------------------------------------------
+*/
+
+#pragma hdrstop
+#include <string.h>
+#include <stdlib.h>
+#include "SerialTransport.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include "rs232.h"
+#else
+#include <chrono>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#endif
+// ---------------------------------------------------------------------------
+
+
+bool SerialTransport::Puts(const char *text) {
+  return Write(text, (int)strlen(text));
+}
+
+void SerialTransport::Discard() {
+  char buffer[64];
+  while(Read(buffer, sizeof(buffer), 0) > 0) {
+  }
+}
+
+
+#ifdef _WIN32
+
+/*Windows backend, using the RS232 library. The library numbers the ports
+from 0, so COMn is port n-1. */
+class Rs232Transport : public SerialTransport {
+public:
+  int port_nmr;
+
+  Rs232Transport(int port) : port_nmr(port) {}
+
+  ~Rs232Transport() {
+	RS232_CloseComport(port_nmr);
+  }
+
+  bool Write(const char *data, int length) {
+	return RS232_SendBuf(port_nmr, (unsigned char *)data, length) == length;
+  }
+
+  int Read(char *buffer, int size, int timeout) {
+	DWORD t_start = GetTickCount();
+	while(true) {
+	  int n = RS232_PollComport(port_nmr, (unsigned char *)buffer, size);
+	  if(n != 0 || (long)(GetTickCount() - t_start) >= timeout) {
+		return n;
+	  }
+	  Sleep(1);
+	}
+  }
+
+  bool SetDTR(bool on) {
+	if(on) {
+	  RS232_enableDTR(port_nmr);
+	}
+	else {
+	  RS232_disableDTR(port_nmr);
+	}
+	return true;
+  }
+};
+
+#else
+
+/*Linux backend, using termios. */
+class TermiosTransport : public SerialTransport {
+public:
+  int fd;
+
+  TermiosTransport(int fd_) : fd(fd_) {}
+
+  ~TermiosTransport() {
+	close(fd);
+  }
+
+  bool Write(const char *data, int length) {
+	while(length > 0) {
+	  ssize_t n = write(fd, data, length);
+	  if(n < 0) {
+		if(errno == EINTR) {
+		  continue;
+		}
+		return false;
+	  }
+	  data += n;
+	  length -= (int)n;
+	}
+	return true;
+  }
+
+  int Read(char *buffer, int size, int timeout) {
+	struct pollfd p;
+	p.fd = fd;
+	p.events = POLLIN;
+	/*A signal interrupts poll(...) and read(...) with EINTR, which is not an
+	error; poll(...) is then restarted with the time left. */
+	auto t_end = std::chrono::steady_clock::now() +
+				 std::chrono::milliseconds(timeout);
+	int ready;
+	while((ready = poll(&p, 1, timeout)) < 0 && errno == EINTR) {
+	  auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+		t_end - std::chrono::steady_clock::now()).count();
+	  timeout = left > 0 ? (int)left : 0;
+	}
+	if(ready <= 0) {
+	  return ready;
+	}
+	ssize_t n;
+	while((n = read(fd, buffer, size)) < 0 && errno == EINTR) {
+	}
+	return (int)n;
+  }
+
+  bool SetDTR(bool on) {
+	int dtr = TIOCM_DTR;
+	return ioctl(fd, on ? TIOCMBIS : TIOCMBIC, &dtr) == 0;
+  }
+};
+
+/*Pseudo-terminal backend. Same as termios, but DTR is sent in-band. */
+class PtyTransport : public TermiosTransport {
+public:
+  PtyTransport(int fd_) : TermiosTransport(fd_) {}
+
+  bool SetDTR(bool on) {
+	char c = on ? PtyDtrOn : PtyDtrOff;
+	return Write(&c, 1);
+  }
+};
+
+/*Converts the baud rate to the termios speed constant. */
+static speed_t TermiosSpeed(int baud) {
+  switch(baud) {
+  case 1200: return B1200;
+  case 2400: return B2400;
+  case 4800: return B4800;
+  case 9600: return B9600;
+  case 19200: return B19200;
+  case 38400: return B38400;
+  case 57600: return B57600;
+  case 115200: return B115200;
+  }
+  return B0;
+}
+
+/*Opens the device in raw mode with the baud rate and the mode string
+"<data bits><parity N/E/O><stop bits>", as used by the RS232 library. */
+static int TermiosOpen(const char *device, int baud, const char *mode) {
+
+  speed_t speed = TermiosSpeed(baud);
+  if(speed == B0 || strlen(mode) != 3) {
+	return -1;
+  }
+
+  int fd = open(device, O_RDWR | O_NOCTTY);
+  if(fd < 0) {
+	return -1;
+  }
+
+  struct termios tio;
+  if(tcgetattr(fd, &tio) != 0) {
+	close(fd);
+	return -1;
+  }
+  cfmakeraw(&tio);
+  cfsetispeed(&tio, speed);
+  cfsetospeed(&tio, speed);
+
+  tio.c_cflag &= ~(CSIZE | PARENB | PARODD | CSTOPB);
+  tio.c_cflag |= CLOCAL | CREAD;
+  switch(mode[0]) {
+  case '5': tio.c_cflag |= CS5; break;
+  case '6': tio.c_cflag |= CS6; break;
+  case '7': tio.c_cflag |= CS7; break;
+  default: tio.c_cflag |= CS8; break;
+  }
+  if(mode[1] == 'E' || mode[1] == 'e') {
+	tio.c_cflag |= PARENB;
+  }
+  if(mode[1] == 'O' || mode[1] == 'o') {
+	tio.c_cflag |= PARENB | PARODD;
+  }
+  if(mode[2] == '2') {
+	tio.c_cflag |= CSTOPB;
+  }
+  tio.c_cc[VMIN] = 0;
+  tio.c_cc[VTIME] = 0;
+
+  if(tcsetattr(fd, TCSANOW, &tio) != 0) {
+	close(fd);
+	return -1;
+  }
+  return fd;
+}
+
+#endif
+
+
+SerialTransport *OpenSerialTransport(const char *port, int baud,
+	const char *mode) {
+
+#ifdef _WIN32
+  int port_nmr = atoi(port)-1;
+  if(RS232_OpenComport(port_nmr, baud, mode)) {
+	return NULL;
+  }
+  return new Rs232Transport(port_nmr);
+#else
+  bool pty = strncmp(port, "pty:", 4) == 0;
+  int fd = TermiosOpen(pty ? port+4 : port, baud, mode);
+  if(fd < 0) {
+	return NULL;
+  }
+  if(pty) {
+	return new PtyTransport(fd);
+  }
+  return new TermiosTransport(fd);
+#endif
+}
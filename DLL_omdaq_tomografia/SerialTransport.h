@@ -0,0 +1,58 @@
+// ---------------------------------------------------------------------------
+/* SerialTransport.h
+
+ Serial port used to talk to the V8849 motor control board and to switch the
+ power of the motor (DTR pin of the noise port).
+
+ The driver only uses the SerialTransport interface, so the same code runs
+ with any of the backends:
+
+  - Windows: the RS232 library (rs232.h). The port is the COM number, e.g.
+	"5" for COM5.
+  - Linux: termios. The port is the device, e.g. "/dev/ttyUSB0". DTR is
+	switched with ioctl(TIOCMBIS / TIOCMBIC).
+  - Pseudo-terminal: the port is "pty:" followed by the device of the slave
+	side, e.g. "pty:/dev/pts/4", normally created by the V8849 emulator.
+	A pseudo-terminal has no modem lines, so DTR changes are sent as the
+	single characters PtyDtrOn and PtyDtrOff. This is only used on the noise
+	port, which carries no other data.
+
+ OpenSerialTransport(...) chooses the backend from the port string and
+ returns NULL if the port cannot be opened. The port is closed by deleting
+ the transport.
+ ---------------------------------------------------------------------------
+*/
+
+#ifndef SerialTransportH
+#define SerialTransportH
+
+#define PtyDtrOn  '\x12'
+#define PtyDtrOff '\x14'
+
+class SerialTransport {
+public:
+  virtual ~SerialTransport() {}
+
+  /*Writes length characters. Returns false if they could not be written. */
+  virtual bool Write(const char *data, int length) = 0;
+
+  /*Reads up to size characters, waiting at most timeout milliseconds for the
+  first one. Returns the number of characters read, 0 on timeout or -1 on
+  error. */
+  virtual int Read(char *buffer, int size, int timeout) = 0;
+
+  /*Sets (on = true) or clears the DTR pin. */
+  virtual bool SetDTR(bool on) = 0;
+
+  /*Writes a null terminated string, e.g. an order built with V8849Orders.h */
+  bool Puts(const char *text);
+
+  /*Discards any characters waiting to be read. */
+  void Discard();
+};
+
+/*Opens port with baud rate baud and mode (e.g. "8N1") */
+SerialTransport *OpenSerialTransport(const char *port, int baud,
+	const char *mode);
+
+#endif
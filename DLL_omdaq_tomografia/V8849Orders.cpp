@@ -0,0 +1,151 @@
+// ---------------------------------------------------------------------------
+/* V8849Orders.cpp
+
+ Encoding of the orders sent to the V8849 (RS Components) programmable
+ stepper motor control board. See V8849Orders.h
+ ---------------------------------------------------------------------------
+*/
+
+#pragma hdrstop
+#include "V8849Orders.h"
+// ---------------------------------------------------------------------------
+
+
+/*Starts a new order in the buffer. */
+static void OrderBegin(V8849Order *order) {
+  order->length = 0;
+}
+
+/*Appends a text to the order. The text is truncated if the buffer is full,
+which does not happen for the orders defined here. */
+static void OrderText(V8849Order *order, const char *text) {
+  while(*text != 0 && order->length < V8849OrderSize-2) {
+	order->text[order->length++] = *text++;
+  }
+}
+
+/*Appends an integer to the order as decimal digits. The digits are written
+backwards in a small local buffer and then copied to the order. */
+static void OrderNumber(V8849Order *order, long val) {
+
+  char digits[24];
+  int n = 0;
+  unsigned long u = (val < 0) ? 0UL - (unsigned long)val : (unsigned long)val;
+
+  do {
+	digits[n++] = (char)('0' + u % 10);
+	u /= 10;
+  } while(u != 0);
+
+  if(val < 0) {
+	digits[n++] = '-';
+  }
+
+  while(n > 0 && order->length < V8849OrderSize-2) {
+	order->text[order->length++] = digits[--n];
+  }
+}
+
+/*Terminates the order with the new line character and returns its text. */
+static const char *OrderEnd(V8849Order *order) {
+  order->text[order->length++] = '\n';
+  order->text[order->length] = 0;
+  return order->text;
+}
+
+
+const char *V8849New(V8849Order *order) {
+  OrderBegin(order);
+  OrderText(order, "new");
+  return OrderEnd(order);
+}
+
+const char *V8849Prescale(V8849Order *order, long p) {
+  OrderBegin(order);
+  OrderText(order, "prescale(");
+  OrderNumber(order, p);
+  OrderText(order, ")");
+  return OrderEnd(order);
+}
+
+const char *V8849Cvel(V8849Order *order, long u) {
+  OrderBegin(order);
+  OrderText(order, "cvel(");
+  OrderNumber(order, u);
+  OrderText(order, ")");
+  return OrderEnd(order);
+}
+
+const char *V8849Datum(V8849Order *order, int axis, long val) {
+  OrderBegin(order);
+  OrderText(order, "datum(");
+  OrderNumber(order, axis);
+  OrderText(order, ",");
+  OrderNumber(order, val);
+  OrderText(order, ")");
+  return OrderEnd(order);
+}
+
+const char *V8849Cmove(V8849Order *order, long val, int axis) {
+  OrderBegin(order);
+  OrderText(order, "Cmove(");
+  OrderNumber(order, val);
+  OrderText(order, ",");
+  OrderNumber(order, axis);
+  OrderText(order, ")");
+  return OrderEnd(order);
+}
+
+const char *V8849PrintPos(V8849Order *order, int axis) {
+  OrderBegin(order);
+  OrderText(order, "print(pos(");
+  OrderNumber(order, axis);
+  OrderText(order, "))");
+  return OrderEnd(order);
+}
+
+const char *V8849SeqDeclare(V8849Order *order, int n) {
+  OrderBegin(order);
+  OrderText(order, "int seq[");
+  OrderNumber(order, n);
+  OrderText(order, "];");
+  return OrderEnd(order);
+}
+
+const char *V8849SeqEntry(V8849Order *order, int i, long val) {
+  OrderBegin(order);
+  OrderText(order, "seq[");
+  OrderNumber(order, i);
+  OrderText(order, "]=");
+  OrderNumber(order, val);
+  OrderText(order, ";");
+  return OrderEnd(order);
+}
+
+const char *V8849SeqIndexDeclare(V8849Order *order) {
+  OrderBegin(order);
+  OrderText(order, "int iseq;");
+  return OrderEnd(order);
+}
+
+const char *V8849SeqIndexSet(V8849Order *order, long i) {
+  OrderBegin(order);
+  OrderText(order, "iseq=");
+  OrderNumber(order, i);
+  OrderText(order, ";");
+  return OrderEnd(order);
+}
+
+const char *V8849SeqFunction(V8849Order *order, int axis) {
+  OrderBegin(order);
+  OrderText(order, "void adv(){Cmove(seq[iseq],");
+  OrderNumber(order, axis);
+  OrderText(order, ");iseq=iseq+1;}");
+  return OrderEnd(order);
+}
+
+const char *V8849SeqTrigger(V8849Order *order) {
+  OrderBegin(order);
+  OrderText(order, "adv()");
+  return OrderEnd(order);
+}
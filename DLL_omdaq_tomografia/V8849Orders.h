@@ -0,0 +1,56 @@
+// ---------------------------------------------------------------------------
+/* V8849Orders.h
+
+ Encoding of the orders sent to the V8849 (RS Components) programmable
+ stepper motor control board.
+
+ Every order is written into a V8849Order, a fixed size buffer that can be
+ reused for any number of orders. The integer arguments (motor steps, speeds,
+ etc.) are written directly as decimal digits, so no memory is allocated and
+ no floating point numbers are converted to text. Each function returns the
+ text of the order, terminated by "\n" and ready to be sent with
+ SerialTransport::Puts(...) (see SerialTransport.h).
+ ---------------------------------------------------------------------------
+*/
+
+#ifndef V8849OrdersH
+#define V8849OrdersH
+
+/*Size of the buffer of an order. The longest order is the definition of the
+adv() function of an angle sequence. */
+#define V8849OrderSize 64
+
+struct V8849Order {
+  char text[V8849OrderSize];
+  int length;
+};
+
+// "new" - erases any program in the board
+const char *V8849New(V8849Order *order);
+
+// "prescale(p)" - the speed set by cvel(u) is divided by p
+const char *V8849Prescale(V8849Order *order, long p);
+
+// "cvel(u)" - sets the speed of the motors to u steps/second
+const char *V8849Cvel(V8849Order *order, long u);
+
+// "datum(axis,val)" - sets the position of motor "axis" to val steps
+const char *V8849Datum(V8849Order *order, int axis, long val);
+
+// "Cmove(val,axis)" - moves motor "axis" to the absolute position val
+const char *V8849Cmove(V8849Order *order, long val, int axis);
+
+// "print(pos(axis))" - asks the board for the position of motor "axis"
+const char *V8849PrintPos(V8849Order *order, int axis);
+
+/*Orders of the angle sequence program (see XyzLoadAngleSequence(...)):
+  "int seq[n];", "seq[i]=val;", "int iseq;", "iseq=i;",
+  "void adv(){Cmove(seq[iseq],axis);iseq=iseq+1;}" and the trigger "adv()" */
+const char *V8849SeqDeclare(V8849Order *order, int n);
+const char *V8849SeqEntry(V8849Order *order, int i, long val);
+const char *V8849SeqIndexDeclare(V8849Order *order);
+const char *V8849SeqIndexSet(V8849Order *order, long i);
+const char *V8849SeqFunction(V8849Order *order, int axis);
+const char *V8849SeqTrigger(V8849Order *order);
+
+#endif
@@ -0,0 +1,183 @@
+///--------------------------------------------------------------------------
+// OMXYZDLLEXT.H
+// Declarations of the extended functions exported from the simulated stage
+// OMXYZDLL.DLL.
+//
+// These calls are not part of the OMDAQ-3 interface defined in OmXyzDll.h
+// (which must not be changed).  They are used by test programs that drive the
+// simulator directly.
+// OmXyzDll.h must be included before this file.
+// ---------------------------------------------------------------------------
+
+#ifndef OmXyzDllExtH
+#define OmXyzDllExtH
+
+// A time source returns the time in seconds.  Only differences between
+// times are used, so the origin doesn't matter, but it must never go back.
+typedef double (_CALLSTYLE_ *XyzTimeSource)();
+
+// A stage context.  Each XYZSTAGE is a separate simulated stage with its own
+// state, so one process can run many stages, from as many threads.  The
+// OMDAQ-3 calls of OmXyzDll.h work on a default stage.
+typedef struct XyzStage *XYZSTAGE;
+
+// Clock modes for XyzSimSetClockMode
+#define XyzClockReal    0   // real (monotonic) time
+#define XyzClockVirtual 1   // time only advances with XyzSimAdvanceClock
+#define XyzClockScaled  2   // real time multiplied by a scale factor
+
+#include "../DLL_omdaq_common/XyzStatusLayout.h"
+
+// XyzSnapshot.Time is the simulation time, see XyzSimGetTime.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  // Simulation clock +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  //
+  // XyzSimSetTimeSource replaces the clock used to simulate the motion.
+  // NULL restores the default monotonic clock.
+  XYZ_DLL bool _CALLSTYLE_ XyzSimSetTimeSource(XyzTimeSource Source);
+  //
+  // XyzSimSetClockMode selects a real, virtual or scaled clock (e.g. Scale =
+  // 1000 runs the simulation 1000 times faster than real time).  Changing the
+  // mode doesn't disturb moves in progress.
+  XYZ_DLL bool _CALLSTYLE_ XyzSimSetClockMode(int Mode, double Scale = 1);
+  //
+  // XyzSimAdvanceClock moves the virtual clock forward.  Only valid in
+  // XyzClockVirtual mode.
+  XYZ_DLL bool _CALLSTYLE_ XyzSimAdvanceClock(double Seconds);
+  //
+  // XyzSimGetTime returns the simulation time in seconds.
+  XYZ_DLL bool _CALLSTYLE_ XyzSimGetTime(double *Seconds);
+  //
+  // +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+  // Motion profile ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  //
+  // XyzSimSetJerk sets the jerk limit of each axis, in mm/s3 (LinJerk[3]) and
+  // deg/s3 (RotJerk[3]).  Moves then follow a seven-segment S-curve within the
+  // speed, acceleration and jerk limits.  0 (the default) means no jerk limit,
+  // i.e. a trapezoidal profile.
+  XYZ_DLL bool _CALLSTYLE_ XyzSimSetJerk(double *LinJerk, double *RotJerk);
+  //
+  // XyzSimTimeToGo returns in LinTime[3] and RotTime[3] the time (s) left
+  // until each axis finishes its move.  0 for axes at rest.
+  XYZ_DLL bool _CALLSTYLE_ XyzSimTimeToGo(double *LinTime, double *RotTime);
+  //
+  // +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+  // Stage snapshot +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  //
+  // XyzGetSnapshot returns in one call what XyzGetPosition, XyzGetAngle,
+  // XyzStageStatus and XyzGetMotorTemp return, all taken from the same state
+  // of the stage, so the values are always consistent with each other.
+  XYZ_DLL bool _CALLSTYLE_ XyzGetSnapshot(struct XyzSnapshot *Snapshot);
+  //
+  // +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+  // Status polling +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  //
+  // XyzStatusDelta is XyzStageStatus for programs that poll at a high rate.
+  // Generation and Status must hold what the previous call returned (0 and 0
+  // for the first call).  If nothing changed since then it returns false at
+  // once, without working out the status.  Otherwise it updates Generation
+  // and Status and returns in Changed the status bits that changed and in
+  // ChangedAxes a bit (1 << i) for each axis i (0 to 5) with changed bits.
+  // It returns true if any bit changed.
+  XYZ_DLL bool _CALLSTYLE_ XyzStatusDelta(unsigned *Generation,
+	  DRVSTAT *Status, DRVSTAT *Changed, int *ChangedAxes);
+  //
+  // XyzWaitStatusChange waits, without polling, until any bit of Mask in the
+  // stage status changes (e.g. ST_ANY_R1_MOVING when a move ends) or until
+  // Timeout milliseconds have passed.  It returns the status in Status (if
+  // not NULL) and true if a bit of Mask changed, false after the timeout.
+  XYZ_DLL bool _CALLSTYLE_ XyzWaitStatusChange(DRVSTAT Mask, int Timeout,
+	  DRVSTAT *Status = NULL);
+  //
+  // +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+  // Motion callback ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  //
+  // XyzSetMotionCallback makes the stage call Callback(User, ...) from its own
+  // thread as soon as an axis reaches its target, hits a limit or faults, so
+  // that the host doesn't have to poll for the end of a move.  NULL removes
+  // the callback; once XyzSetMotionCallback returns it is no longer called.
+  // XyzShutDown also removes it.  Callback must return quickly.  It may call
+  // the other routines, XyzSetMotionCallback and XyzShutDown included, but
+  // not XyzDestroyStage on its own stage, which then returns false.
+  XYZ_DLL bool _CALLSTYLE_ XyzSetMotionCallback(XyzMotionCallback Callback,
+	  void *User);
+  //
+  // +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+  // Stage contexts +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  //
+  // XyzCreateStage returns a new stage (NULL if it fails), which must be
+  // initialised with XyzCtxInitialise.  XyzDestroyStage shuts it down and
+  // frees it.  The default stage can't be destroyed.
+  XYZ_DLL XYZSTAGE _CALLSTYLE_ XyzCreateStage();
+  XYZ_DLL bool _CALLSTYLE_ XyzDestroyStage(XYZSTAGE Stage);
+  //
+  // The XyzCtx calls are the calls of OmXyzDll.h and of this file on a given
+  // stage.  The calls that don't depend on the stage (capabilities, version,
+  // descriptions and option headers) have no XyzCtx version.
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxOptionValue(XYZSTAGE Stage, int nHdr,
+	  char * optionVal, int szOptionVal);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxInitialise(XYZSTAGE Stage, char **options,
+	  int szOptions);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxShutDown(XYZSTAGE Stage);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxSetCurrentPosition(XYZSTAGE Stage,
+	  double * NewPosition);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxSetCurrentAngle(XYZSTAGE Stage,
+	  double * NewAngle);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxSetAccel(XYZSTAGE Stage, double * NewAccel);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxSetSpeed(XYZSTAGE Stage, double * NewSpeed);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxSetRotAccel(XYZSTAGE Stage, double * NewAccel);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxSetRotSpeed(XYZSTAGE Stage, double * NewSpeed);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxPowerOn(XYZSTAGE Stage, bool Enabled);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxMoveToPosition(XYZSTAGE Stage,
+	  double * NewPosition);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxMoveToAngle(XYZSTAGE Stage, double * NewAngle);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxHalt(XYZSTAGE Stage);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxGetPosition(XYZSTAGE Stage,
+	  double * CurrentPosition);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxGetAngle(XYZSTAGE Stage, double * CurrentAngle);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxGetMotorTemp(XYZSTAGE Stage, double *MotorTemp,
+	  int iAxis);
+  XYZ_DLL DRVSTAT _CALLSTYLE_ XyzCtxStageStatus(XYZSTAGE Stage,
+	  DWORD * AxisStatus);
+  XYZ_DLL DRVSTAT _CALLSTYLE_ XyzCtxAxisStatus(XYZSTAGE Stage, int iAxis,
+	  DWORD * AxisStatus);
+  XYZ_DLL int _CALLSTYLE_ XyzCtxFaultAck(XYZSTAGE Stage);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxLastFaultText(XYZSTAGE Stage, char *statusText,
+	  int nChar);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxSimSetTimeSource(XYZSTAGE Stage,
+	  XyzTimeSource Source);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxSimSetClockMode(XYZSTAGE Stage, int Mode,
+	  double Scale = 1);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxSimAdvanceClock(XYZSTAGE Stage, double Seconds);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxSimGetTime(XYZSTAGE Stage, double *Seconds);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxSimSetJerk(XYZSTAGE Stage, double *LinJerk,
+	  double *RotJerk);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxSimTimeToGo(XYZSTAGE Stage, double *LinTime,
+	  double *RotTime);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxGetSnapshot(XYZSTAGE Stage,
+	  struct XyzSnapshot *Snapshot);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxStatusDelta(XYZSTAGE Stage,
+	  unsigned *Generation, DRVSTAT *Status, DRVSTAT *Changed,
+	  int *ChangedAxes);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxWaitStatusChange(XYZSTAGE Stage, DRVSTAT Mask,
+	  int Timeout, DRVSTAT *Status = NULL);
+  XYZ_DLL bool _CALLSTYLE_ XyzCtxSetMotionCallback(XYZSTAGE Stage,
+	  XyzMotionCallback Callback, void *User);
+  //
+  // +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#ifdef __cplusplus
+} // End of extern "C"
+#endif
+
+#endif
@@ -0,0 +1,17 @@
+///--------------------------------------------------------------------------
+// SIMCONFIG.H
+// Stage simulated by this DLL.  The simulator itself is
+// ../DLL_omdaq_common/OmXyzSimulator.cpp, compiled with this folder in the
+// include path.
+// ---------------------------------------------------------------------------
+
+#ifndef SimConfigH
+#define SimConfigH
+
+// The simulated stage is XYZ + 3 rotations, all moved by the simulator, with
+// power switching and temperature sensors (see XyzStageConfig.h).
+typedef XyzStageConfig<3, 3, XYZCAP_POWER_ONOFF | XYZCAP_TEMPSENSOR> SimConfig;
+
+#define SimDescription "XYZ stage controlled by user-supplied DLL"
+
+#endif
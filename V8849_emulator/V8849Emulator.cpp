@@ -0,0 +1,543 @@
+// ---------------------------------------------------------------------------
+
+/* V8849Emulator.cpp
+
+ Emulator of the V8849 (RS Components) programmable stepper motor control
+ board, to test and benchmark the tomography DLL (DLL_omdaq_tomografia)
+ without the real motor. Runs on Linux.
+
+ The emulator creates two pseudo-terminals and prints their devices:
+
+  - the board port, which receives the orders of the board language;
+  - the noise port, whose DTR line switches the power of the motor. A
+	pseudo-terminal has no modem lines, so the DLL sends the DTR changes as
+	single characters (PtyDtrOn / PtyDtrOff, see SerialTransport.h).
+
+ Use "pty:<device>" as the COM and COM (noise) options of the DLL.
+
+ Only the subset of the board language used by the DLL is implemented:
+
+	new                      erases the program (variables and functions)
+	prescale(p)              divides the speed set by cvel by p
+	cvel(u)                  sets the speed to u steps/second
+	datum(axis,val)          sets the position of motor "axis" to val
+	Cmove(val,axis)          moves motor "axis" to the absolute position val
+	print(expr)              prints the value of an expression
+	pos(axis)                position of motor "axis" (in expressions)
+	int name; int name[n];   integer variables and arrays
+	name=expr; name[i]=expr; assignments
+	void name(){...}         function definitions, called as name()
+
+ Several statements can be sent in one line, separated by ";". Expressions
+ accept integer numbers, variables, array elements, calls, "+" and "-".
+
+ The motors move in real time at cvel/prescale steps per second, and only
+ while the motor is powered. Cmove returns immediately, as on the board.
+ On exit (Ctrl+C) the emulator prints the number of orders, moves and power
+ cycles and the time that the motor was powered.
+
+ Build:   g++ -std=c++11 -O2 -o V8849Emulator V8849Emulator.cpp
+ Usage:   V8849Emulator [-v] [-e] [-d delay]
+		  -v        prints every order received
+		  -e        echoes every order, as a terminal would
+		  -d delay  delays the answers by delay milliseconds
+ ---------------------------------------------------------------------------
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+#include "../DLL_omdaq_tomografia/SerialTransport.h"
+
+using namespace std;
+
+#define nMotors 2
+
+
+// ______Global variables____________________________
+
+/*State of the motors. Positions are kept as doubles so that slow speeds
+advance by fractions of a step in each loop; the reported position is the
+whole number of steps already done. */
+double MotorPosition[nMotors];
+long MotorTarget[nMotors];
+long Cvel = 200;
+long Prescale = 1;
+bool MotorPowered = false;
+
+/*Program of the board: variables, arrays and functions. */
+map<string, long> Variables;
+map<string, vector<long> > Arrays;
+map<string, string> Functions;
+
+/*Options and statistics */
+bool Verbose = false;
+bool Echo = false;
+long AnswerDelay = 0;
+long OrderCount = 0;
+long MoveCount = 0;
+long PowerCycles = 0;
+double PoweredTime = 0;
+volatile sig_atomic_t Quit = 0;
+
+/*Board port and the text waiting to be sent to it */
+int board_fd = -1;
+string Answer;
+
+
+/******************************* Board language *******************************/
+
+/*Erases the program: variables, arrays and functions. The speed and the
+positions of the motors are kept. */
+void NewProgram() {
+  Variables.clear();
+  Arrays.clear();
+  Functions.clear();
+}
+
+/*Parser of one statement or expression. Errors are reported by setting
+"error", in which case the statement is ignored, as the board would report a
+syntax error. */
+struct Parser {
+  const char *p;
+  bool error;
+
+  Parser(const char *text) : p(text), error(false) {}
+
+  void Blanks() {
+	while(*p == ' ' || *p == '\t') {
+	  ++p;
+	}
+  }
+
+  bool Accept(char c) {
+	Blanks();
+	if(*p == c) {
+	  ++p;
+	  return true;
+	}
+	return false;
+  }
+
+  void Expect(char c) {
+	if(!Accept(c)) {
+	  error = true;
+	}
+  }
+
+  string Name() {
+	Blanks();
+	string name;
+	while(isalnum((unsigned char)*p) || *p == '_') {
+	  name += *p++;
+	}
+	return name;
+  }
+
+  bool AtEnd() {
+	Blanks();
+	return *p == 0;
+  }
+
+  long Expression();
+  long Term();
+  long Call(const string &name);
+  void Statement();
+};
+
+/*Executes a list of statements separated by ";", e.g. the body of a
+function or a line received from the DLL. Braces are kept together so that
+function definitions are not split. */
+void Execute(const string &text) {
+
+  int depth = 0;
+  string statement;
+
+  for (size_t i = 0; i <= text.size(); ++i) {
+	char c = (i < text.size()) ? text[i] : ';';
+	if(c == '{') {
+	  ++depth;
+	}
+	if(c == '}') {
+	  --depth;
+	}
+	if(c == ';' && depth == 0) {
+	  Parser parser(statement.c_str());
+	  if(!parser.AtEnd()) {
+		parser.Statement();
+		if(parser.error && Verbose) {
+		  printf("  syntax error: %s\n", statement.c_str());
+		}
+	  }
+	  statement.clear();
+	  continue;
+	}
+	statement += c;
+	if(c == '}' && depth == 0) {
+	  Parser parser(statement.c_str());
+	  parser.Statement();
+	  statement.clear();
+	}
+  }
+}
+
+long Parser::Expression() {
+  long value = Term();
+  while(!error) {
+	if(Accept('+')) {
+	  value += Term();
+	}
+	else if(Accept('-')) {
+	  value -= Term();
+	}
+	else {
+	  break;
+	}
+  }
+  return value;
+}
+
+long Parser::Term() {
+
+  Blanks();
+  if(Accept('-')) {
+	return -Term();
+  }
+  if(Accept('(')) {
+	long value = Expression();
+	Expect(')');
+	return value;
+  }
+  if(isdigit((unsigned char)*p)) {
+	return strtol(p, (char **)&p, 10);
+  }
+
+  string name = Name();
+  if(name.empty()) {
+	error = true;
+	return 0;
+  }
+  if(Accept('(')) {
+	return Call(name);
+  }
+  if(Accept('[')) {
+	long i = Expression();
+	Expect(']');
+	vector<long> &a = Arrays[name];
+	if(i < 0 || i >= (long)a.size()) {
+	  error = true;
+	  return 0;
+	}
+	return a[i];
+  }
+  return Variables[name];
+}
+
+/*Calls a built in or a user function. The opening bracket was already
+read. */
+long Parser::Call(const string &name) {
+
+  vector<long> args;
+  if(!Accept(')')) {
+	do {
+	  args.push_back(Expression());
+	} while(!error && Accept(','));
+	Expect(')');
+  }
+  if(error) {
+	return 0;
+  }
+
+  if(name == "new" && args.empty()) {
+	NewProgram();
+  }
+  else if(name == "prescale" && args.size() == 1 && args[0] >= 1) {
+	Prescale = args[0];
+  }
+  else if(name == "cvel" && args.size() == 1) {
+	Cvel = args[0];
+  }
+  else if(name == "datum" && args.size() == 2 && args[0] >= 0 && args[0] < nMotors) {
+	MotorPosition[args[0]] = args[1];
+	MotorTarget[args[0]] = args[1];
+  }
+  else if(name == "Cmove" && args.size() == 2 && args[1] >= 0 && args[1] < nMotors) {
+	MotorTarget[args[1]] = args[0];
+	++MoveCount;
+  }
+  else if(name == "pos" && args.size() == 1 && args[0] >= 0 && args[0] < nMotors) {
+	return (long)MotorPosition[args[0]];
+  }
+  else if(name == "print" && args.size() == 1) {
+	Answer += to_string(args[0]) + "\r\n";
+  }
+  else if(Functions.count(name) && args.empty()) {
+	Execute(Functions[name]);
+  }
+  else {
+	error = true;
+  }
+  return 0;
+}
+
+void Parser::Statement() {
+
+  string name = Name();
+
+  if(name == "new" && AtEnd()) {
+	NewProgram();
+	return;
+  }
+
+  if(name == "int") {
+	string var = Name();
+	if(Accept('[')) {
+	  long n = Expression();
+	  Expect(']');
+	  if(!error && n >= 0) {
+		Arrays[var].assign(n, 0);
+	  }
+	}
+	else {
+	  Variables[var] = 0;
+	}
+	return;
+  }
+
+  if(name == "void") {
+	string function = Name();
+	Expect('(');
+	Expect(')');
+	Expect('{');
+	const char *end = strrchr(p, '}');
+	if(error || end == NULL) {
+	  error = true;
+	  return;
+	}
+	Functions[function] = string(p, end);
+	return;
+  }
+
+  if(Accept('(')) {
+	Call(name);
+	return;
+  }
+
+  if(Accept('[')) {
+	long i = Expression();
+	Expect(']');
+	Expect('=');
+	long value = Expression();
+	vector<long> &a = Arrays[name];
+	if(!error && i >= 0 && i < (long)a.size()) {
+	  a[i] = value;
+	}
+	return;
+  }
+
+  Expect('=');
+  long value = Expression();
+  if(!error) {
+	Variables[name] = value;
+  }
+}
+
+
+/******************************* Emulator *******************************/
+
+/*Creates a pseudo-terminal and returns the master side. The slave side is
+also kept open by the emulator (slave_fd) so that the master doesn't report
+a hang up while the DLL is not connected, and is set to raw mode so that the
+answers of the board are not echoed back. */
+int OpenPty(int *slave_fd, string *device) {
+
+  int fd = posix_openpt(O_RDWR | O_NOCTTY);
+  if(fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0) {
+	return -1;
+  }
+  *device = ptsname(fd);
+
+  *slave_fd = open(device->c_str(), O_RDWR | O_NOCTTY);
+  if(*slave_fd < 0) {
+	return -1;
+  }
+  struct termios tio;
+  tcgetattr(*slave_fd, &tio);
+  cfmakeraw(&tio);
+  tcsetattr(*slave_fd, TCSANOW, &tio);
+  return fd;
+}
+
+/*Writes the n characters of data to fd. The pty is blocking, so write(...)
+waits while its buffer is full, but it may write only part of data, so it is
+repeated until everything is written. Interrupted writes are retried.
+Returns false if the pty fails, e.g. because the DLL closed it. */
+bool WriteAll(int fd, const char *data, size_t n) {
+
+  while(n > 0) {
+	ssize_t written = write(fd, data, n);
+	if(written > 0) {
+	  data += written;
+	  n -= written;
+	  continue;
+	}
+	if(written < 0 && errno == EINTR) {
+	  continue;
+	}
+	return false;
+  }
+  return true;
+}
+
+/*Moves the motors towards their targets for dt seconds. */
+void MoveMotors(double dt) {
+
+  if(!MotorPowered || Prescale <= 0) {
+	return;
+  }
+  PoweredTime += dt;
+
+  double steps = (double)Cvel/Prescale*dt;
+  for (int i = 0; i < nMotors; ++i) {
+	double distance = MotorTarget[i] - MotorPosition[i];
+	if(distance > steps) {
+	  MotorPosition[i] += steps;
+	}
+	else if(distance < -steps) {
+	  MotorPosition[i] -= steps;
+	}
+	else {
+	  MotorPosition[i] = MotorTarget[i];
+	}
+  }
+}
+
+void OnSignal(int) {
+  Quit = 1;
+}
+
+int main(int argc, char *argv[]) {
+
+  for (int i = 1; i < argc; ++i) {
+	if(strcmp(argv[i], "-v") == 0) {
+	  Verbose = true;
+	}
+	else if(strcmp(argv[i], "-e") == 0) {
+	  Echo = true;
+	}
+	else if(strcmp(argv[i], "-d") == 0 && i+1 < argc) {
+	  AnswerDelay = atol(argv[++i]);
+	}
+	else {
+	  fprintf(stderr, "Usage: %s [-v] [-e] [-d delay]\n", argv[0]);
+	  return 1;
+	}
+  }
+
+  int board_slave, noise_slave;
+  string board_device, noise_device;
+  board_fd = OpenPty(&board_slave, &board_device);
+  int noise_fd = OpenPty(&noise_slave, &noise_device);
+  if(board_fd < 0 || noise_fd < 0) {
+	perror("Cannot create pseudo-terminals");
+	return 1;
+  }
+
+  printf("V8849 emulator\n");
+  printf("  COM         pty:%s\n", board_device.c_str());
+  printf("  COM (noise) pty:%s\n", noise_device.c_str());
+  fflush(stdout);
+
+  signal(SIGINT, OnSignal);
+  signal(SIGTERM, OnSignal);
+
+  string line;
+  auto t_last = chrono::steady_clock::now();
+  auto t_answer = t_last;
+
+  while(!Quit) {
+
+	struct pollfd fds[2];
+	fds[0].fd = board_fd;
+	fds[0].events = POLLIN;
+	fds[1].fd = noise_fd;
+	fds[1].events = POLLIN;
+	poll(fds, 2, 1);
+
+	auto t_now = chrono::steady_clock::now();
+	MoveMotors(chrono::duration<double>(t_now - t_last).count());
+	t_last = t_now;
+
+	char buffer[256];
+
+	if(fds[1].revents & POLLIN) {
+	  int n = read(noise_fd, buffer, sizeof(buffer));
+	  for (int i = 0; i < n; ++i) {
+		bool powered = MotorPowered;
+		if(buffer[i] == PtyDtrOn) {
+		  powered = true;
+		}
+		if(buffer[i] == PtyDtrOff) {
+		  powered = false;
+		}
+		if(powered != MotorPowered) {
+		  MotorPowered = powered;
+		  if(powered) {
+			++PowerCycles;
+		  }
+		  if(Verbose) {
+			printf("[power %s]\n", powered ? "on" : "off");
+		  }
+		}
+	  }
+	}
+
+	if(fds[0].revents & POLLIN) {
+	  int n = read(board_fd, buffer, sizeof(buffer));
+	  for (int i = 0; i < n; ++i) {
+		if(buffer[i] != '\n' && buffer[i] != '\r') {
+		  line += buffer[i];
+		  continue;
+		}
+		if(line.empty()) {
+		  continue;
+		}
+		++OrderCount;
+		if(Verbose) {
+		  printf("%s\n", line.c_str());
+		}
+		if(Echo) {
+		  Answer += line + "\r\n";
+		}
+		bool answering = !Answer.empty();
+		Execute(line);
+		if(!answering && !Answer.empty()) {
+		  t_answer = t_now + chrono::milliseconds(AnswerDelay);
+		}
+		line.clear();
+	  }
+	}
+
+	if(!Answer.empty() && t_now >= t_answer) {
+	  if(!WriteAll(board_fd, Answer.data(), Answer.size())) {
+		perror("Cannot answer on the board pty");
+	  }
+	  Answer.clear();
+	}
+  }
+
+  printf("\n%ld orders, %ld moves, %ld power cycles, motor powered %.3f s\n",
+	  OrderCount, MoveCount, PowerCycles, PoweredTime);
+  return 0;
+}
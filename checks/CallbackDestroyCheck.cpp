@@ -0,0 +1,60 @@
+// ---------------------------------------------------------------------------
+//
+// Check of XyzDestroyStage on the simulator while the motion callback of the
+// stage is running.
+//
+// Usage:  CallbackDestroyCheck
+//
+// The callback of each of 5 stages removes itself, which detaches its thread
+// (see SimStopCallback), and then takes 100 ms to return while another
+// thread destroys the stage.  It checks that:
+//  - XyzDestroyStage succeeds;
+//  - it only returns after the callback has returned, since the thread still
+//    uses the stage then.
+// ---------------------------------------------------------------------------
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "OmXyzDll.h"
+#include "OmXyzDllExt.h"
+#include "Checks.h"
+
+XYZSTAGE Stage;
+std::atomic<bool> Entered(false);
+std::atomic<bool> Returned(false);
+
+void _CALLSTYLE_ RemoveItself(void *, DRVSTAT, const XyzSnapshot *) {
+  XyzCtxSetMotionCallback(Stage, NULL, NULL);
+  Entered = true;
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  Returned = true;
+}
+
+int main() {
+  double Speed[3] = {10, 10, 10};
+  double Target[3] = {1, 0, 0};
+  char *Options[2] = {(char *)"1", (char *)"9600"};
+  for (int k = 0; k < 5; ++k) {
+	Stage = XyzCreateStage();
+	Check(XyzCtxInitialise(Stage, Options, 2), "XyzCtxInitialise");
+	XyzCtxSetSpeed(Stage, Speed);
+	XyzCtxSetAccel(Stage, Speed);
+	XyzCtxSimSetClockMode(Stage, XyzClockScaled, 100);
+	Entered = false;
+	Returned = false;
+	XyzCtxSetMotionCallback(Stage, RemoveItself, NULL);
+	XyzCtxMoveToPosition(Stage, Target);
+	Clock::time_point Start = Clock::now();
+	while (!Entered && Milliseconds(Start) < 5000) {
+	  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	Check(Entered, "the callback is called");
+	Check(XyzDestroyStage(Stage), "XyzDestroyStage succeeds");
+	Check(Returned, "XyzDestroyStage waits for the callback to return");
+  }
+  printf("5 stages destroyed during their callbacks\n");
+
+  return ChecksResult();
+}
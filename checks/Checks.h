@@ -0,0 +1,46 @@
+// ---------------------------------------------------------------------------
+//
+// Common part of the programs of this folder.  Each check that fails is
+// printed by Check; ChecksResult prints how many failed and gives the exit
+// status of the program, 1 if any failed and 0 if all passed.  TimeOf and
+// Milliseconds time the benchmarks.
+//
+// ---------------------------------------------------------------------------
+#ifndef ChecksH
+#define ChecksH
+
+#include <stdio.h>
+#include <chrono>
+
+typedef std::chrono::steady_clock Clock;
+
+int Failures = 0;
+
+void Check(bool ok, const char *What) {
+  if (!ok) {
+	printf("FAILED: %s\n", What);
+	++Failures;
+  }
+}
+
+int ChecksResult() {
+  printf(Failures ? "%d checks failed\n" : "ok\n", Failures);
+  return Failures ? 1 : 0;
+}
+
+// Time (ms) since Start.
+double Milliseconds(Clock::time_point Start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - Start).count();
+}
+
+// Time of one call of Poll in ns, over n calls.
+template <class F> double TimeOf(int n, F Poll) {
+  Clock::time_point Start = Clock::now();
+  for (int k = 0; k < n; ++k) {
+	Poll();
+  }
+  return std::chrono::duration<double, std::nano>(Clock::now() -
+	  Start).count() / n;
+}
+
+#endif
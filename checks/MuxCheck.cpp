@@ -0,0 +1,164 @@
+// ---------------------------------------------------------------------------
+//
+// Check of the move hand-over of the multiplexer (DLL_omdaq_multiplexer).
+// run_checks.sh runs it with the universal simulator as both back-ends,
+// loaded from two files so that each role has a back-end and a worker of
+// its own.
+//
+// Usage:  MuxCheck <linear DLL> <rotary DLL>
+//
+// It checks that:
+//  - XyzMoveToPosition and XyzMoveToAngle return at once and the two moves
+//    run at the same time;
+//  - from the return of a move call its axes are reported moving until the
+//    back-end has reached the target, never in position at the previous one
+//    (threads ask the status during many short moves, to catch the worker
+//    passing a move on while MuxStatus asks the back-end);
+//  - a DLL named for both roles is loaded once, and XyzInitialise fails if
+//    the rotary options differ from the linear ones.
+// ---------------------------------------------------------------------------
+#include <math.h>
+#include <stdio.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "OmXyzDll.h"
+#include "Checks.h"
+
+bool Initialise(const char *Linear, const char *LinearOptions,
+	const char *Rotary, const char *RotaryOptions) {
+  char *Options[4] = {(char *)Linear, (char *)LinearOptions, (char *)Rotary,
+	  (char *)RotaryOptions};
+  return XyzInitialise(Options, 4);
+}
+
+// Powers the stage, sets the speeds to 20 mm/s and 20 deg/s and the
+// position and angle to 0.
+void Prepare() {
+  double Speed[3] = {20, 20, 20};
+  double Accel[3] = {1000, 1000, 1000};
+  double Zero[3] = {0, 0, 0};
+  XyzSetSpeed(Speed);
+  XyzSetAccel(Accel);
+  XyzSetRotSpeed(Speed);
+  XyzSetRotAccel(Accel);
+  XyzPowerOn(true);
+  XyzSetCurrentPosition(Zero);
+  XyzSetCurrentAngle(Zero);
+}
+
+// Short moves of the hand-over check: move k goes to Target(k) on the X
+// axis and the rotation.  Issued is the last move whose calls returned, -1
+// while they are made.
+std::atomic<int> Issued(-1);
+std::atomic<bool> StopPolling(false);
+std::atomic<int> Early(0);
+
+double Target(int k) {
+  return 0.01 * (k % 2 + 1);
+}
+
+// Asks the status until StopPolling and counts the axes in position
+// somewhere else than the target of the last move.  There are more of these
+// threads than processors, so that some are preempted inside the status
+// call while the worker passes a move on.
+void Poll() {
+  while (!StopPolling) {
+	int k = Issued;
+	DRVSTAT Status = XyzStageStatus(NULL);
+	double Position[3];
+	double Angle[3];
+	XyzGetPosition(Position);
+	XyzGetAngle(Angle);
+	if (k < 0 || Issued != k) {
+	  continue;
+	}
+	Early += ((Status & ST_AX1_INPOSITION) &&
+		fabs(Position[0] - Target(k)) > 1e-6) +
+		((Status & ST_RO1_INPOSITION) && fabs(Angle[0] - Target(k)) > 1e-6);
+  }
+}
+
+// Waits until all of Bits are set, for 10 s at most.  Returns the time from
+// Start in ms, or -1 on timeout.
+double WaitFor(DRVSTAT Bits, Clock::time_point Start) {
+  while (Milliseconds(Start) < 10000) {
+	if ((XyzStageStatus(NULL) & Bits) == Bits) {
+	  return Milliseconds(Start);
+	}
+	std::this_thread::sleep_for(std::chrono::microseconds(200));
+  }
+  return -1;
+}
+
+int main(int argc, char **argv) {
+  if (argc != 3) {
+	fprintf(stderr, "Usage: %s <linear DLL> <rotary DLL>\n", argv[0]);
+	return 2;
+  }
+
+  // Two back-ends: 10 mm and 10 deg at 20 per second take 0.5 s each.
+  Check(Initialise(argv[1], "", argv[2], ""), "XyzInitialise");
+  Prepare();
+  double Position[3] = {10, 10, 10};
+  double Angle[3] = {10, 0, 0};
+  Clock::time_point Start = Clock::now();
+  XyzMoveToPosition(Position);
+  XyzMoveToAngle(Angle);
+  double Calls = Milliseconds(Start);
+  DRVSTAT Status = XyzStageStatus(NULL);
+  Check(Calls < 50, "the move calls return at once");
+  Check((Status & ST_AX1_MOVING) && (Status & ST_RO1_MOVING) &&
+	  !(Status & (ST_AX1_INPOSITION | ST_RO1_INPOSITION)),
+	  "both roles are moving after the calls");
+  double Linear = WaitFor(ST_ALL_XYZ_INPOSITION, Start);
+  double Rotary = WaitFor(ST_RO1_INPOSITION, Start);
+  printf("calls %.3f ms, linear in position after %.0f ms, rotary %.0f ms\n",
+	  Calls, Linear, Rotary);
+  Check(Linear >= 450 && Rotary >= 450, "the moves take 0.5 s");
+  Check(Linear < 900 && Rotary < 900, "the moves run at the same time");
+
+  // Short moves back and forth, each started once the previous one is over.
+  std::vector<std::thread> Pollers;
+  int nPollers = 2 * std::max(2u, std::thread::hardware_concurrency());
+  for (int i = 0; i < nPollers; ++i) {
+	Pollers.push_back(std::thread(Poll));
+  }
+  for (int k = 0; k < 1000; ++k) {
+	double Move[3] = {Target(k), 0, 0};
+	Issued = -1;
+	XyzMoveToPosition(Move);
+	XyzMoveToAngle(Move);
+	Issued = k;
+	WaitFor(ST_AX1_INPOSITION | ST_RO1_INPOSITION, Clock::now());
+  }
+  StopPolling = true;
+  for (std::thread &Poller : Pollers) {
+	Poller.join();
+  }
+  printf("%d statuses in position before the target of the move\n",
+	  (int)Early);
+  Check(Early == 0, "no move is in position before its target");
+  XyzGetPosition(Position);
+  XyzShutDown();
+
+  // One DLL for both roles.
+  Check(!Initialise(argv[1], "", argv[1], "COM9"),
+	  "XyzInitialise fails with other rotary options for the same DLL");
+  Check(Initialise(argv[1], "COM9", argv[1], ""),
+	  "XyzInitialise with the same DLL for both roles");
+  Prepare();
+  Start = Clock::now();
+  XyzMoveToPosition(Position);
+  XyzMoveToAngle(Position);
+  Check(WaitFor(ST_ALL_XYZ_INPOSITION | ST_RO1_INPOSITION, Start) >= 0,
+	  "both roles reach their target through one back-end");
+  XyzGetAngle(Angle);
+  Check(fabs(Angle[0] - Position[0]) < 1e-6, "the angle is the target");
+  XyzShutDown();
+
+  return ChecksResult();
+}
@@ -0,0 +1,68 @@
+// ---------------------------------------------------------------------------
+//
+// Benchmark of the status polls of the simulator, to compare the builds:
+// run_checks.sh builds it for DLL_omdaq_universal (six axes simulated) and
+// DLL_omdaq_IAEA_2axes (two).
+//
+// Usage:  PollLatencyBench
+//
+// Times XyzStageStatus without and with the detail words, XyzGetSnapshot
+// and XyzStatusDelta, with the stage at rest and with all its axes moving.
+//
+// Returns 0.
+// ---------------------------------------------------------------------------
+#include <stdio.h>
+
+#include "OmXyzDll.h"
+#include "OmXyzDllExt.h"
+#include "Checks.h"
+
+// Calls timed by TimeOf.
+const int nTimed = 2000000;
+
+void TimePolls(const char *State) {
+  DWORD Detail[6];
+  XyzSnapshot Snapshot;
+  unsigned Generation = 0;
+  DRVSTAT Status = 0;
+  DRVSTAT Changed;
+  int ChangedAxes;
+  double Bare = TimeOf(nTimed, [] {
+	XyzStageStatus(NULL);
+  });
+  double Detailed = TimeOf(nTimed, [&] {
+	XyzStageStatus(Detail);
+  });
+  double OneCall = TimeOf(nTimed, [&] {
+	XyzGetSnapshot(&Snapshot);
+  });
+  double Delta = TimeOf(nTimed, [&] {
+	XyzStatusDelta(&Generation, &Status, &Changed, &ChangedAxes);
+  });
+  printf("%s: XyzStageStatus %.1f ns, with detail words %.1f ns,"
+	  " XyzGetSnapshot %.1f ns, XyzStatusDelta %.1f ns\n", State, Bare,
+	  Detailed, OneCall, Delta);
+}
+
+int main() {
+  char Description[80] = {};
+  XyzDescription(Description, sizeof(Description) - 1);
+  printf("%s\n", Description);
+
+  double Speed[3] = {1, 1, 1};
+  double Zero[3] = {0, 0, 0};
+  XyzSetSpeed(Speed);
+  XyzSetRotSpeed(Speed);
+  XyzPowerOn(true);
+  XyzSetCurrentPosition(Zero);
+  XyzSetCurrentAngle(Zero);
+  TimePolls("at rest");
+
+  // Moves of 10 minutes, longer than the benchmark.
+  double Target[3] = {600, 600, 600};
+  XyzMoveToPosition(Target);
+  XyzMoveToAngle(Target);
+  TimePolls("moving");
+  XyzHalt();
+  return 0;
+}
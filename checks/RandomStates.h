@@ -0,0 +1,61 @@
+// ---------------------------------------------------------------------------
+//
+// Random states of the simulator, for the checks of DLL_omdaq_universal and
+// DLL_omdaq_IAEA_2axes.  StartRandomStates gives the simulator a clock of
+// its own; each NextRandomState then makes a random move, angle move or
+// power change and moves that clock forward by 0 to 3 s.  The targets go
+// past the limits of the simulator (20 mm and 90 deg), so the states cover
+// moving, in position and at a limit.
+//
+// ---------------------------------------------------------------------------
+#ifndef RandomStatesH
+#define RandomStatesH
+
+#include <stdlib.h>
+
+#include "OmXyzDll.h"
+#include "OmXyzDllExt.h"
+
+double RandomStateTime = 1000;
+bool RandomStatePower = false;
+
+double _CALLSTYLE_ RandomStateClock() {
+  return RandomStateTime;
+}
+
+void StartRandomStates(unsigned Seed) {
+  double Speed[3] = {10, 10, 10};
+  double RotSpeed[3] = {30, 30, 30};
+  double Accel[3] = {20, 20, 20};
+  srand(Seed);
+  XyzSimSetTimeSource(RandomStateClock);
+  XyzSetSpeed(Speed);
+  XyzSetRotSpeed(RotSpeed);
+  XyzSetAccel(Accel);
+  XyzSetRotAccel(Accel);
+}
+
+void NextRandomState() {
+  double Target[3];
+  switch (rand() % 4) {
+  case 0:
+	for (int i = 0; i < 3; ++i) {
+	  Target[i] = rand() % 81 - 40;
+	}
+	XyzMoveToPosition(Target);
+	break;
+  case 1:
+	for (int i = 0; i < 3; ++i) {
+	  Target[i] = rand() % 301 - 150;
+	}
+	XyzMoveToAngle(Target);
+	break;
+  case 2:
+	RandomStatePower = rand() % 2;
+	XyzPowerOn(RandomStatePower);
+	break;
+  }
+  RandomStateTime += (rand() % 300) / 100.0;
+}
+
+#endif
@@ -0,0 +1,53 @@
+// ---------------------------------------------------------------------------
+//
+// Check of the single-axis queries of the simulator: XyzAxisStatus and
+// XyzGetMotorTemp with iAxis >= 0.
+//
+// Usage:  SingleAxisCheck
+//
+// For 20000 random states it checks that:
+//  - XyzAxisStatus(i) gives the bits of axis i of XyzStageStatus, and no
+//    bits of other axes;
+//  - its detail word is AxisStatus[i] of XyzStageStatus;
+//  - XyzGetMotorTemp(i) gives MotorTemp[i] of the query of all the axes;
+// and that both calls refuse iAxis = 6.
+// ---------------------------------------------------------------------------
+#include <stdio.h>
+
+#include "OmXyzDll.h"
+#include "OmXyzDllExt.h"
+#include "RandomStates.h"
+#include "Checks.h"
+
+int main() {
+  int WrongStatus = 0;
+  int WrongDetail = 0;
+  int WrongTemp = 0;
+  StartRandomStates(17);
+  for (int k = 0; k < 20000; ++k) {
+	NextRandomState();
+	DWORD Detail[6];
+	double Temp[6];
+	DRVSTAT Status = XyzStageStatus(Detail);
+	XyzGetMotorTemp(Temp, -1);
+	for (int i = 0; i < 6; ++i) {
+	  DWORD AxisDetail = 0xFFFFFFFF;
+	  double AxisTemp = -1;
+	  WrongStatus += XyzAxisStatus(i, &AxisDetail) !=
+		  (Status & XyzAxisFlags(i, 0xFF));
+	  WrongDetail += AxisDetail != Detail[i];
+	  WrongTemp += !XyzGetMotorTemp(&AxisTemp, i) || AxisTemp != Temp[i];
+	}
+  }
+  printf("of 120000 single-axis queries: %d wrong status, %d wrong detail"
+	  " words, %d wrong temperatures\n", WrongStatus, WrongDetail, WrongTemp);
+  Check(WrongStatus == 0, "XyzAxisStatus gives the bits of its axis");
+  Check(WrongDetail == 0, "XyzAxisStatus gives the detail word of its axis");
+  Check(WrongTemp == 0, "XyzGetMotorTemp gives the temperature of its axis");
+
+  double Temp;
+  Check(XyzAxisStatus(6, NULL) == 0, "XyzAxisStatus refuses axis 6");
+  Check(!XyzGetMotorTemp(&Temp, 6), "XyzGetMotorTemp refuses axis 6");
+
+  return ChecksResult();
+}
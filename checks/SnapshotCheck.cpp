@@ -0,0 +1,71 @@
+// ---------------------------------------------------------------------------
+//
+// Check and benchmark of XyzGetSnapshot on the simulator.
+//
+// Usage:  SnapshotCheck
+//
+// For 20000 random states it checks that the snapshot holds the simulation
+// time and exactly what XyzGetPosition, XyzGetAngle, XyzGetMotorTemp and
+// XyzStageStatus return.  Then it times one snapshot against those four
+// calls.
+// ---------------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+
+#include "OmXyzDll.h"
+#include "OmXyzDllExt.h"
+#include "RandomStates.h"
+#include "Checks.h"
+
+// Calls timed by TimeOf.
+const int nTimed = 1000000;
+
+int main() {
+  int Different = 0;
+  StartRandomStates(19);
+  for (int k = 0; k < 20000; ++k) {
+	NextRandomState();
+	XyzSnapshot Snapshot;
+	double Position[3];
+	double Angle[3];
+	double Temp[6];
+	DWORD Detail[6];
+	XyzGetSnapshot(&Snapshot);
+	XyzGetPosition(Position);
+	XyzGetAngle(Angle);
+	XyzGetMotorTemp(Temp, -1);
+	DRVSTAT Status = XyzStageStatus(Detail);
+	Different += Snapshot.Time != RandomStateTime ||
+		memcmp(Snapshot.Position, Position, sizeof(Position)) != 0 ||
+		memcmp(Snapshot.Angle, Angle, sizeof(Angle)) != 0 ||
+		memcmp(Snapshot.MotorTemp, Temp, sizeof(Temp)) != 0 ||
+		Snapshot.Status != Status ||
+		memcmp(Snapshot.AxisStatus, Detail, sizeof(Detail)) != 0;
+  }
+  printf("%d of 20000 snapshots differ from the separate calls\n", Different);
+  Check(Different == 0, "the snapshot holds what the separate calls return");
+
+  // The last state, with moves still going on.
+  double Target[3] = {15, 15, 15};
+  XyzMoveToPosition(Target);
+  XyzMoveToAngle(Target);
+  RandomStateTime += 0.5;
+  XyzSnapshot Snapshot;
+  double Position[3];
+  double Angle[3];
+  double Temp[6];
+  DWORD Detail[6];
+  double OneCall = TimeOf(nTimed, [&] {
+	XyzGetSnapshot(&Snapshot);
+  });
+  double FourCalls = TimeOf(nTimed, [&] {
+	XyzGetPosition(Position);
+	XyzGetAngle(Angle);
+	XyzGetMotorTemp(Temp, -1);
+	XyzStageStatus(Detail);
+  });
+  printf("one poll: XyzGetSnapshot %.1f ns, four calls %.1f ns\n", OneCall,
+	  FourCalls);
+
+  return ChecksResult();
+}
@@ -0,0 +1,72 @@
+// ---------------------------------------------------------------------------
+//
+// Check and benchmark of XyzStatusDelta on the simulator.
+//
+// Usage:  StatusDeltaCheck
+//
+// Polls the simulator 60000 times with XyzStatusDelta during random moves
+// and power changes, with the clock moved forward by 0 to 0.1 s between
+// polls, and checks at each poll that:
+//  - the status it keeps up to date is XyzStageStatus;
+//  - Changed holds the bits that changed since the previous poll;
+//  - ChangedAxes holds the axes of those bits;
+//  - it returns true only if a bit changed.
+// Then it times a poll of a stage at rest against XyzStageStatus.
+// ---------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "OmXyzDll.h"
+#include "OmXyzDllExt.h"
+#include "RandomStates.h"
+#include "Checks.h"
+
+// Calls timed by TimeOf.
+const int nTimed = 4000000;
+
+int main() {
+  unsigned Generation = 0;
+  DRVSTAT Status = 0;
+  DRVSTAT Previous = 0;
+  int Wrong = 0;
+  int Unchanged = 0;
+  StartRandomStates(20);
+  for (int k = 0; k < 60000; ++k) {
+	if (k % 10 == 0) {
+	  NextRandomState();
+	}
+	else {
+	  RandomStateTime += (rand() % 3) * 0.05;
+	}
+	DRVSTAT Changed;
+	int ChangedAxes;
+	bool Any = XyzStatusDelta(&Generation, &Status, &Changed, &ChangedAxes);
+	int Axes = 0;
+	for (int i = 0; i < 6; ++i) {
+	  Axes |= (((Changed >> XyzStatusShift[i]) & 0xFF) != 0) << i;
+	}
+	Wrong += Status != XyzStageStatus(NULL) ||
+		Changed != (Status ^ Previous) || ChangedAxes != Axes ||
+		Any != (Changed != 0);
+	Unchanged += !Any;
+	Previous = Status;
+  }
+  printf("%d of 60000 polls wrong, %d unchanged\n", Wrong, Unchanged);
+  Check(Wrong == 0, "XyzStatusDelta follows XyzStageStatus");
+
+  // A stage at rest: nothing changes.
+  RandomStateTime += 100;
+  DRVSTAT Changed;
+  int ChangedAxes;
+  XyzStatusDelta(&Generation, &Status, &Changed, &ChangedAxes);
+  double Delta = TimeOf(nTimed, [&] {
+	XyzStatusDelta(&Generation, &Status, &Changed, &ChangedAxes);
+  });
+  double Full = TimeOf(nTimed, [] {
+	XyzStageStatus(NULL);
+  });
+  printf("poll of a stage at rest: XyzStatusDelta %.1f ns,"
+	  " XyzStageStatus %.1f ns\n", Delta, Full);
+
+  return ChecksResult();
+}
@@ -0,0 +1,147 @@
+// ---------------------------------------------------------------------------
+//
+// Check and benchmark of the status mask of the simulator: XyzAxisStatus
+// builds it from per-axis tests shifted into the byte of each axis (see
+// XyzStatusShift in OmXyzDllExt.h), where it used switch ladders.
+//
+// Usage:  StatusMaskBench
+//
+// Checks that XyzStageStatus gives the mask of the old switch ladders
+// (LadderStatus below) for 20000 random states, the ladders being given the
+// state read through XyzGetPosition, XyzGetAngle and XyzSimTimeToGo.  Then
+// times both ways of building the mask from the same tests, and the whole
+// XyzStageStatus call, and prints their cost at 1000 polls per second.
+// ---------------------------------------------------------------------------
+#include <stdio.h>
+
+#include "OmXyzDll.h"
+#include "OmXyzDllExt.h"
+#include "RandomStates.h"
+#include "Checks.h"
+
+// The tests of the six axes of one state.
+struct AxisTests {
+  bool Moving[6];
+  bool NegLim[6];
+  bool PosLim[6];
+  bool PowerOn;
+};
+
+// The tests of the current state of the simulator.
+AxisTests ReadTests() {
+  AxisTests Tests;
+  double Position[6];
+  double TimeToGo[6];
+  XyzGetPosition(Position);
+  XyzGetAngle(Position + 3);
+  XyzSimTimeToGo(TimeToGo, TimeToGo + 3);
+  for (int i = 0; i < 6; ++i) {
+	double Limit = (i < 3) ? 20.0 : 90.0;
+	Tests.Moving[i] = TimeToGo[i] > 0;
+	Tests.NegLim[i] = Position[i] < -Limit;
+	Tests.PosLim[i] = Position[i] > Limit;
+  }
+  Tests.PowerOn = RandomStatePower;
+  return Tests;
+}
+
+// The mask as the simulator built it before: a switch ladder per flag.
+DRVSTAT LadderStatus(const AxisTests &Tests) {
+  DRVSTAT status = 0;
+  for (int i = 0; i < 6; ++i) {
+	if (Tests.Moving[i]) {
+	  switch (i) {
+	  case 0: status |= ST_AX1_MOVING; break;
+	  case 1: status |= ST_AX2_MOVING; break;
+	  case 2: status |= ST_AX3_MOVING; break;
+	  case 3: status |= ST_RO1_MOVING; break;
+	  case 4: status |= ST_RO2_MOVING; break;
+	  case 5: status |= ST_RO3_MOVING; break;
+	  }
+	}
+	else {
+	  switch (i) {
+	  case 0: status |= ST_AX1_INPOSITION; break;
+	  case 1: status |= ST_AX2_INPOSITION; break;
+	  case 2: status |= ST_AX3_INPOSITION; break;
+	  case 3: status |= ST_RO1_INPOSITION; break;
+	  case 4: status |= ST_RO2_INPOSITION; break;
+	  case 5: status |= ST_RO3_INPOSITION; break;
+	  }
+	}
+	if (Tests.NegLim[i]) {
+	  switch (i) {
+	  case 0: status |= ST_AX1_NEGLIM; break;
+	  case 1: status |= ST_AX2_NEGLIM; break;
+	  case 2: status |= ST_AX3_NEGLIM; break;
+	  case 3: status |= ST_RO1_NEGLIM; break;
+	  case 4: status |= ST_RO2_NEGLIM; break;
+	  case 5: status |= ST_RO3_NEGLIM; break;
+	  }
+	}
+	if (Tests.PosLim[i]) {
+	  switch (i) {
+	  case 0: status |= ST_AX1_POSLIM; break;
+	  case 1: status |= ST_AX2_POSLIM; break;
+	  case 2: status |= ST_AX3_POSLIM; break;
+	  case 3: status |= ST_RO1_POSLIM; break;
+	  case 4: status |= ST_RO2_POSLIM; break;
+	  case 5: status |= ST_RO3_POSLIM; break;
+	  }
+	}
+  }
+  if (Tests.PowerOn) {
+	status |= (ST_ALL_XYZ_MOTORS_ON | ST_ALL_R3_MOTORS_ON);
+  }
+  return status;
+}
+
+// The mask as the simulator builds it now (see SimStatus).
+DRVSTAT ShiftedStatus(const AxisTests &Tests) {
+  DRVSTAT status = 0;
+  DRVSTAT PowerOn = Tests.PowerOn;
+  for (int i = 0; i < 6; ++i) {
+	DRVSTAT Moving = Tests.Moving[i];
+	DRVSTAT Flags = Moving * XyzStMoving | (1 - Moving) * XyzStInPosition |
+		(DRVSTAT)Tests.NegLim[i] * XyzStNegLim |
+		(DRVSTAT)Tests.PosLim[i] * XyzStPosLim | PowerOn * XyzStMotorOn;
+	status |= XyzAxisFlags(i, Flags);
+  }
+  return status;
+}
+
+int main() {
+  static AxisTests Tests[4096];
+  StartRandomStates(7);
+  int Different = 0;
+  for (int k = 0; k < 20000; ++k) {
+	NextRandomState();
+	AxisTests Now = ReadTests();
+	Different += XyzStageStatus(NULL) != LadderStatus(Now);
+	Tests[k & 4095] = Now;
+  }
+  printf("%d of 20000 states differ from the switch ladders\n", Different);
+  Check(Different == 0, "XyzStageStatus gives the mask of the switch ladders");
+
+  // Each call builds the mask of the next of Tests[0 .. 4095].
+  const int nTimed = 4000000;
+  volatile DRVSTAT Sink = 0;
+  int k = 0;
+  double Ladder = TimeOf(nTimed, [&] {
+	Sink = Sink ^ LadderStatus(Tests[k++ & 4095]);
+  });
+  double Shifted = TimeOf(nTimed, [&] {
+	Sink = Sink ^ ShiftedStatus(Tests[k++ & 4095]);
+  });
+  double Call = TimeOf(nTimed, [&] {
+	Sink = Sink ^ XyzStageStatus(NULL);
+  });
+  printf("mask from the tests: switch ladders %.1f ns, shifted flags %.1f ns\n",
+	  Ladder, Shifted);
+  printf("XyzStageStatus call %.1f ns\n", Call);
+  printf("at 1000 polls per second the mask takes %.1f us/s with the switch"
+	  " ladders and %.1f us/s with the shifted flags, the calls %.1f us/s\n",
+	  Ladder, Shifted, Call);
+
+  return ChecksResult();
+}
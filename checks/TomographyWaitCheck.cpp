@@ -0,0 +1,84 @@
+// ---------------------------------------------------------------------------
+//
+// Check of XyzWaitStatusChange on the tomography DLL, against the V8849
+// emulator (V8849_emulator).
+//
+// Usage:  TomographyWaitCheck <board port> <noise port>
+//
+// It checks that:
+//  - the wait returns false after its timeout when nothing changes;
+//  - moves of 45 deg at 90 deg/s, each waited for with XyzWaitStatusChange
+//    until ST_RO1_MOVING clears, end in position at their target, without a
+//    fault, and not before the motor can have got there (0.5 s);
+//  - two moves requested one after the other, which the worker merges, end
+//    at the second target without a fault, although the second one alone is
+//    much shorter than the whole travel.
+// Prints the time from each move call to the return of the wait.
+// ---------------------------------------------------------------------------
+#include <math.h>
+#include <stdio.h>
+#include <string>
+
+#include "OmXyzDll.h"
+#include "OmXyzDllExt.h"
+#include "Checks.h"
+
+int main(int argc, char **argv) {
+  if (argc != 3) {
+	fprintf(stderr, "Usage: %s <board port> <noise port>\n", argv[0]);
+	return 2;
+  }
+  std::string Board = std::string("pty:") + argv[1];
+  std::string Noise = std::string("pty:") + argv[2];
+  // COM, baud and mode of both ports, speed, steps/rotation, hold and
+  // settle times.
+  const char *Options[10] = {Board.c_str(), "9600", "8N1", Noise.c_str(),
+	  "9600", "8N1", "90", "800", "0", "0"};
+  Check(XyzInitialise((char **)Options, 10), "XyzInitialise");
+  double Zero[3] = {0, 0, 0};
+  XyzSetCurrentAngle(Zero);
+
+  Clock::time_point Start = Clock::now();
+  bool Changed = XyzWaitStatusChange(ST_RO1_MOVING, 100, NULL);
+  double Waited = Milliseconds(Start);
+  printf("wait without a change returned after %.1f ms\n", Waited);
+  Check(!Changed && Waited >= 99 && Waited < 200, "the wait times out");
+
+  for (int k = 1; k <= 4; ++k) {
+	double Target[3] = {45.0 * k, 0, 0};
+	double Angle[3];
+	Start = Clock::now();
+	XyzMoveToAngle(Target);
+	DRVSTAT Status = XyzStageStatus(NULL);
+	while ((Status & ST_RO1_MOVING) && Milliseconds(Start) < 10000) {
+	  XyzWaitStatusChange(ST_RO1_MOVING, 5000, &Status);
+	}
+	Waited = Milliseconds(Start);
+	XyzGetAngle(Angle);
+	printf("move to %.0f deg: done after %.0f ms at %.2f deg\n", Target[0],
+		Waited, Angle[0]);
+	Check((Status & ST_RO1_INPOSITION) && !(Status & ST_RO1_HWFAULT),
+		"the move ends in position");
+	Check(fabs(Angle[0] - Target[0]) < 0.5, "the move ends at its target");
+	Check(Waited >= 450, "the wait doesn't return before the motor is there");
+  }
+
+  XyzSetCurrentAngle(Zero);
+  double First[3] = {300, 0, 0}, Second[3] = {310, 0, 0}, Angle[3];
+  Start = Clock::now();
+  XyzMoveToAngle(First);
+  XyzMoveToAngle(Second);
+  DRVSTAT Status = XyzStageStatus(NULL);
+  while ((Status & ST_RO1_MOVING) && Milliseconds(Start) < 10000) {
+	XyzWaitStatusChange(ST_RO1_MOVING, 5000, &Status);
+  }
+  XyzGetAngle(Angle);
+  printf("merged moves to %.0f deg: done after %.0f ms at %.2f deg\n",
+	  Second[0], Milliseconds(Start), Angle[0]);
+  Check((Status & ST_RO1_INPOSITION) && !(Status & ST_RO1_HWFAULT),
+	  "the merged moves end in position");
+  Check(fabs(Angle[0] - Second[0]) < 0.5, "the merged moves end at the target");
+  XyzShutDown();
+
+  return ChecksResult();
+}
@@ -0,0 +1,113 @@
+// ---------------------------------------------------------------------------
+//
+// Benchmark of the encoding of the V8849 orders (V8849Orders.h of the
+// tomography DLL), against the way the DLL built them before: the number of
+// steps as a double through to_string, cut at the '.' and concatenated into
+// a std::string.
+//
+// Usage:  V8849OrdersBench
+//
+// Checks that both give the same text for the numbers of steps of a move,
+// and that encoding an order allocates no memory (operator new is counted).
+// Prints the time and the allocations per order of both.
+// ---------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+#include <string>
+
+#include "V8849Orders.h"
+#include "Checks.h"
+
+long Allocations = 0;
+
+void *operator new(size_t Size) {
+  ++Allocations;
+  void *p = malloc(Size ? Size : 1);
+  if (p == NULL) {
+	throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void *p) noexcept {
+  free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+  free(p);
+}
+
+// The orders as the DLL built them before V8849Orders.
+std::string OldNumber(double x) {
+  std::string s = std::to_string(x);
+  s.erase(s.find("."), std::string::npos);
+  return s;
+}
+
+std::string OldCmove(double Steps) {
+  return "Cmove(" + OldNumber(Steps) + ",0)\n";
+}
+
+std::string OldDatum(double Steps) {
+  return "datum(0," + OldNumber(Steps) + ")\n";
+}
+
+std::string OldCvel(double Speed) {
+  return "cvel(" + OldNumber(Speed) + ")\n";
+}
+
+// Numbers of steps of the moves, at random: up to 2^30 and up to 1000.
+long Steps(int k) {
+  long Big = (long)(((unsigned long)rand() << 16) ^ (unsigned long)rand());
+  return (k % 2) ? Big % 2147483648L - 1073741824L : Big % 2000 - 1000;
+}
+
+int main() {
+  const int nCompared = 200000;
+  const int nTimed = 2000000;
+  V8849Order Order;
+
+  srand(1);
+  int Different = 0;
+  for (int k = 0; k < nCompared; ++k) {
+	long n = Steps(k);
+	Different += strcmp(V8849Cmove(&Order, n, 0), OldCmove(n).c_str()) != 0;
+	Different += strcmp(V8849Datum(&Order, 0, n), OldDatum(n).c_str()) != 0;
+	Different += (n > 0) &&
+		strcmp(V8849Cvel(&Order, n), OldCvel(n).c_str()) != 0;
+  }
+  printf("%d of %d orders differ from the old text\n", Different,
+	  3 * nCompared);
+  Check(Different == 0, "the orders are the same as the old ones");
+
+  // The same numbers for both, taken from a table so that rand() is not
+  // timed.
+  static long Table[4096];
+  for (int k = 0; k < 4096; ++k) {
+	Table[k] = Steps(k);
+  }
+  volatile char Sink = 0;
+
+  int k = 0;
+
+  long Before = Allocations;
+  double New = TimeOf(nTimed, [&] {
+	Sink = Sink + V8849Cmove(&Order, Table[k++ & 4095], 0)[6];
+  });
+  long NewAllocations = Allocations - Before;
+
+  Before = Allocations;
+  double Old = TimeOf(nTimed, [&] {
+	Sink = Sink + OldCmove(Table[k++ & 4095])[6];
+  });
+  long OldAllocations = Allocations - Before;
+
+  printf("Cmove order: V8849Orders %.1f ns, %.2f allocations;"
+	  " to_string %.1f ns, %.2f allocations\n", New,
+	  (double)NewAllocations / nTimed, Old, (double)OldAllocations / nTimed);
+  Check(NewAllocations == 0, "V8849Orders allocates no memory");
+
+  return ChecksResult();
+}
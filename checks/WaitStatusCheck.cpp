@@ -0,0 +1,86 @@
+// ---------------------------------------------------------------------------
+//
+// Check of XyzWaitStatusChange on the simulator, with the real and the
+// scaled clock.
+//
+// Usage:  WaitStatusCheck
+//
+// It checks that:
+//  - the wait returns false after its timeout when nothing changes;
+//  - a wait for ST_AX1_MOVING to clear returns when the move ends, not
+//    before, and on average less than 5 ms after (20 moves, real clock and
+//    a clock 10 times faster; the limits leave room for a loaded machine);
+//  - a wait for ST_AX1_POSLIM returns as the axis passes its limit, 20 mm.
+// Prints the mean and the longest delay from the end of a move to the
+// return of the wait.
+// ---------------------------------------------------------------------------
+#include <stdio.h>
+#include <algorithm>
+
+#include "OmXyzDll.h"
+#include "OmXyzDllExt.h"
+#include "Checks.h"
+
+// Makes 20 moves of 0.5 mm on the X axis, waits for the end of each with
+// XyzWaitStatusChange and checks the delay.  Scale is the speed of the
+// simulation clock.
+void CheckMoveEnds(const char *Name, double Scale) {
+  double Mean = 0;
+  double Longest = 0;
+  bool Early = false;
+  for (int k = 0; k < 20; ++k) {
+	double Target[3] = {0.5 * ((k + 1) % 2), 0, 0};
+	double LinTime[3];
+	double RotTime[3];
+	XyzMoveToPosition(Target);
+	Clock::time_point Start = Clock::now();
+	XyzSimTimeToGo(LinTime, RotTime);
+	double End = 1000 * LinTime[0] / Scale;
+	DRVSTAT Status = XyzStageStatus(NULL);
+	while (Status & ST_AX1_MOVING) {
+	  XyzWaitStatusChange(ST_AX1_MOVING, 5000, &Status);
+	}
+	double Delay = Milliseconds(Start) - End;
+	XyzSimTimeToGo(LinTime, RotTime);
+	Early = Early || LinTime[0] > 0;
+	Mean += Delay / 20;
+	Longest = std::max(Longest, Delay);
+  }
+  printf("%s clock: end of move seen after %.3f ms (longest %.3f ms)\n",
+	  Name, Mean, Longest);
+  Check(!Early, "the wait doesn't return before the end of the move");
+  Check(Mean < 5 && Longest < 100,
+	  "the wait returns soon after the end of the move");
+}
+
+int main() {
+  double Speed[3] = {10, 10, 10};
+  double Accel[3] = {1000, 1000, 1000};
+  double Zero[3] = {0, 0, 0};
+  XyzSetSpeed(Speed);
+  XyzSetAccel(Accel);
+  XyzPowerOn(true);
+  XyzSetCurrentPosition(Zero);
+
+  Clock::time_point Start = Clock::now();
+  bool Changed = XyzWaitStatusChange(ST_ANY_XYZ_MOVING, 50, NULL);
+  double Waited = Milliseconds(Start);
+  printf("wait without a change returned after %.1f ms\n", Waited);
+  Check(!Changed && Waited >= 49 && Waited < 100, "the wait times out");
+
+  CheckMoveEnds("real", 1);
+  XyzSimSetClockMode(XyzClockScaled, 10);
+  CheckMoveEnds("scaled", 10);
+  XyzSimSetClockMode(XyzClockReal);
+
+  double Target[3] = {25, 0, 0};
+  double Position[3];
+  XyzMoveToPosition(Target);
+  XyzWaitStatusChange(ST_AX1_POSLIM, 5000, NULL);
+  XyzGetPosition(Position);
+  printf("positive limit seen at %.4f mm\n", Position[0]);
+  Check(Position[0] > 20 && Position[0] < 20.5,
+	  "the wait returns as the axis passes its limit");
+
+  return ChecksResult();
+}
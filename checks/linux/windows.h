@@ -0,0 +1,34 @@
+// ---------------------------------------------------------------------------
+//
+// The parts of <windows.h> used by the DLLs, to build them with g++ on Linux
+// for the checks (see run_checks.sh).
+//
+// ---------------------------------------------------------------------------
+#ifndef ChecksWindowsH
+#define ChecksWindowsH
+
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <thread>
+
+typedef unsigned long DWORD;
+
+#define ZeroMemory(Destination, Length) memset((Destination), 0, (Length))
+
+inline void Sleep(DWORD Milliseconds) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(Milliseconds));
+}
+
+inline DWORD GetTickCount() {
+  return (DWORD)std::chrono::duration_cast<std::chrono::milliseconds>(
+	  std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// random(n) of the C++ Builder <stdlib.h>, a number from 0 to n - 1.
+// run_checks.sh defines random as ChecksRandom, as glibc has a random().
+inline int ChecksRandom(int n) {
+  return (n > 0) ? rand() % n : 0;
+}
+
+#endif
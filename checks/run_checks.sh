@@ -0,0 +1,136 @@
+#!/bin/bash
+# ---------------------------------------------------------------------------
+#
+# Builds the DLLs, the V8849 emulator and the programs of this folder with
+# g++ on Linux and runs them.
+#
+# Usage:  checks/run_checks.sh [program ...]      (all of them by default)
+#
+# The sources are copied to $CHECKS_BUILD (/tmp/omdaq_checks by default),
+# where the UI64 suffix of the Windows compilers is replaced by ULL, and
+# built with the headers of the linux folder in place of the Windows ones.
+# Each program is linked with the DLL given for it in Programs and returns
+# 0 if its checks pass.  The benchmarks also print their timings, which
+# depend on the machine.
+#
+# ---------------------------------------------------------------------------
+
+# Program, how it is run and the DLLs it is built with (once for each):
+#   run         runs the program;
+#   emulator    runs it against a V8849 emulator started for it, whose board
+#               and noise ports are its arguments;
+#   backends    runs it with the universal simulator built as two back-end
+#               libraries, whose paths are its arguments.
+Programs=(
+  "MuxCheck backends multiplexer"
+  "V8849OrdersBench run orders"
+  "StatusMaskBench run universal"
+  "SingleAxisCheck run universal IAEA_2axes"
+  "SnapshotCheck run universal IAEA_2axes"
+  "StatusDeltaCheck run universal IAEA_2axes"
+  "WaitStatusCheck run universal"
+  "TomographyWaitCheck emulator tomografia"
+  "PollLatencyBench run universal IAEA_2axes"
+  "CallbackDestroyCheck run universal"
+)
+
+Checks=$(cd "$(dirname "$0")" && pwd)
+Repo=$(dirname "$Checks")
+Build=${CHECKS_BUILD:-/tmp/omdaq_checks}
+# Any warning fails the build, as in the DLL builds, except for the pragmas of
+# C++Builder and the string literals stored as char * in the option headers
+# of the OMDAQ-3 sample code.
+Warnings=(-Wall -Wno-unknown-pragmas -Wno-write-strings -Werror)
+Flags=(-std=c++14 -O2 -pthread "${Warnings[@]}" -Ilinux '-D__declspec(x)='
+  '-D__int64=long long' -D__cdecl= -Drandom=ChecksRandom)
+
+# Sources of DLL and its include folder, relative to checks in the copy.
+# "orders" is only the encoding of the V8849 orders of the tomography DLL.
+DllSources() {
+  case $1 in
+    universal | IAEA_2axes)
+      echo "../DLL_omdaq_common/OmXyzSimulator.cpp -I../DLL_omdaq_$1" ;;
+    tomografia)
+      echo "../DLL_omdaq_tomografia/OmXyzDll.cpp" \
+        "../DLL_omdaq_tomografia/SerialTransport.cpp" \
+        "../DLL_omdaq_tomografia/V8849Orders.cpp -I../DLL_omdaq_tomografia" ;;
+    orders)
+      echo "../DLL_omdaq_tomografia/V8849Orders.cpp -I../DLL_omdaq_tomografia" ;;
+    multiplexer)
+      echo "../DLL_omdaq_multiplexer/OmXyzDll.cpp" \
+        "../DLL_omdaq_multiplexer/MuxBackEnd.cpp" \
+        "-I../DLL_omdaq_multiplexer -ldl" ;;
+    *)
+      echo "Unknown DLL $1" >&2
+      return 1 ;;
+  esac
+}
+
+# Runs a program against a new emulator and stops the emulator.
+RunWithEmulator() {
+  "$Build/V8849Emulator" > "$Build/emulator.out" 2>&1 &
+  local Emulator=$! Ports="" Status=0
+  for i in $(seq 50); do
+    Ports=$(sed -n 's/.*pty:\(.*\)$/\1/p' "$Build/emulator.out" | tr '\n' ' ')
+    [ "$(echo $Ports | wc -w)" = 2 ] && break
+    sleep 0.1
+  done
+  timeout 300 "$@" $Ports || Status=$?
+  kill -INT $Emulator
+  wait $Emulator
+  return $Status
+}
+
+set -e
+mkdir -p "$Build"
+rm -rf "$Build/src"
+mkdir "$Build/src"
+cp -r "$Repo"/DLL_omdaq_* "$Repo/V8849_emulator" "$Checks" "$Build/src"
+find "$Build/src" -name '*.h' -o -name '*.cpp' |
+  xargs sed -i 's/\([0-9A-Fa-fx]\)UI64/\1ULL/g'
+cd "$Build/src/checks"
+
+Selected=" $* "
+Failed=""
+for Entry in "${Programs[@]}"; do
+  set -- $Entry
+  Name=$1
+  Kind=$2
+  shift 2
+  if [ "$Selected" != "  " ] && [[ "$Selected" != *" $Name "* ]]; then
+    continue
+  fi
+  case $Kind in
+    emulator)
+      g++ -std=c++11 -O2 "${Warnings[@]}" ../V8849_emulator/V8849Emulator.cpp \
+        -o "$Build/V8849Emulator" ;;
+    backends)
+      # The back-ends have the routine names of the multiplexer, so they
+      # must call their own ones.
+      g++ "${Flags[@]}" -fPIC -shared -Wl,-Bsymbolic \
+        $(DllSources universal) -o "$Build/libuniversal.so"
+      cp "$Build/libuniversal.so" "$Build/libuniversal2.so" ;;
+  esac
+  for Dll in "$@"; do
+    g++ "${Flags[@]}" $Name.cpp $(DllSources $Dll) -o "$Build/${Name}_$Dll"
+    echo "== $Name ($Dll)"
+    set +e
+    case $Kind in
+      run) "$Build/${Name}_$Dll" ;;
+      emulator) RunWithEmulator "$Build/${Name}_$Dll" ;;
+      backends) "$Build/${Name}_$Dll" "$Build/libuniversal.so" \
+          "$Build/libuniversal2.so" ;;
+    esac
+    Status=$?
+    set -e
+    if [ $Status != 0 ]; then
+      Failed="$Failed ${Name}_$Dll"
+    fi
+  done
+done
+
+if [ -n "$Failed" ]; then
+  echo "Failed:$Failed"
+  exit 1
+fi
+echo "All passed"